@@ -47,3 +47,11 @@ void Array_Free(void * Array)
 		free(ARRAY_RAW_DATA(Array));
 	}
 }
+
+void Array_Clear(void * Array)
+{
+	if (Array != NULL)
+	{
+		ARRAY_OCCUPIED(Array) = 0;
+	}
+}
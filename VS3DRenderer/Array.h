@@ -23,6 +23,9 @@ int Array_Length(void* Array);
 // Free the allocated memory for the array
 void Array_Free(void* Array);
 
+// Remove all the elements, but keep the allocated memory to push new ones
+void Array_Clear(void* Array);
+
 
 
 #endif // !ARRAY_H
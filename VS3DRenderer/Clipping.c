@@ -1,9 +1,53 @@
 #include <math.h>
+#include <string.h>
 #include "Clipping.h"
+#include "TriangleSIMD.h" // Only for the SSE2/AVX2 detection
+
+// Any x64 CPU (SSE2 or AVX2 builds) evaluates the distances to 4 clip space planes per instruction
+#if defined(RASTER_SIMD_AVX2) || defined(RASTER_SIMD_SSE2)
+#include <emmintrin.h>
+#define CLIP_SPACE_SIMD
+#endif
 
 #define NUM_FRUSTRUM_PLANES 6
 plane_t FrustrumPlanes[NUM_FRUSTRUM_PLANES];
 
+// Side planes of the guard band (LEFT_PLANE to BOTTOM_PLANE): same as the frustum ones, but with a much wider FOV
+#define NUM_GUARD_BAND_PLANES 4
+plane_t GuardBandPlanes[NUM_GUARD_BAND_PLANES];
+
+// Where the vertices of a polygon are, relative to a plane
+enum
+{
+	POLYGON_INSIDE,
+	POLYGON_OUTSIDE,
+	POLYGON_CROSSING
+};
+
+// Outcode bits of the frustum planes, and of the guard band planes right after them
+#define FRUSTRUM_OUTCODE_MASK ((1 << NUM_FRUSTRUM_PLANES) - 1)
+#define GUARD_BAND_OUTCODE_SHIFT NUM_FRUSTRUM_PLANES
+#define GUARD_BAND_OUTCODE_MASK (((1 << NUM_GUARD_BAND_PLANES) - 1) << GUARD_BAND_OUTCODE_SHIFT)
+#define NEAR_FAR_OUTCODE_MASK ((1 << NEAR_PLANE) | (1 << FAR_PLANE))
+
+// Clip space plane coefficients, one row per component: Distance = X*x + Y*y + Z*z + W*w
+typedef struct
+{
+	float X[NUM_CLIP_SPACE_PLANES];
+	float Y[NUM_CLIP_SPACE_PLANES];
+	float Z[NUM_CLIP_SPACE_PLANES];
+	float W[NUM_CLIP_SPACE_PLANES];
+}clip_space_planes_t;
+
+clip_space_planes_t ClipSpacePlanes;
+
+static float Get_Guard_Band_Scale(int ScreenSize);
+static bool Is_Guard_Band_Clipping(void);
+static int Classify_Outcodes(int Outcode0, int Outcode1, int Outcode2);
+static int Get_Polygon_Side(const polygon_t* Polygon, const plane_t* Plane);
+static void Clip_Polygon_If_Crossing(polygon_t* Polygon, const plane_t* Plane);
+static void Clip_Polygon_Against(polygon_t* Polygon, const plane_t* Plane);
+
 ///////////////////////////////////////////////////////////////////////////////
 // Frustum planes are defined by a point and a normal vector
 ///////////////////////////////////////////////////////////////////////////////
@@ -53,6 +97,123 @@ void Initialize_Frustrum_Planes(float FOVx, float FOVy, float ZNear, float ZFar)
 	FrustrumPlanes[FAR_PLANE].Normal = Vec3_New(0, 0, -1);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Guard band planes, GuardBandScale times wider than the screen
+///////////////////////////////////////////////////////////////////////////////
+// The width of the view at distance z is 2 * z * tan(fov/2), so scaling that
+// tangent scales the visible area the same way in screen space
+///////////////////////////////////////////////////////////////////////////////
+void Initialize_Guard_Band_Planes(float FOVx, float FOVy, int ScreenWidth, int ScreenHeight)
+{
+	float GuardBandScaleX = Get_Guard_Band_Scale(ScreenWidth);
+	float GuardBandScaleY = Get_Guard_Band_Scale(ScreenHeight);
+
+	float Half_FOVx = atan(tan(FOVx / 2) * GuardBandScaleX);
+	float Half_FOVy = atan(tan(FOVy / 2) * GuardBandScaleY);
+
+	for (int idx = 0; idx < NUM_GUARD_BAND_PLANES; idx++)
+	{
+		GuardBandPlanes[idx].Point = Vec3_New(0, 0, 0);
+	}
+	GuardBandPlanes[LEFT_PLANE].Normal = Vec3_New(cos(Half_FOVx), 0, sin(Half_FOVx));
+	GuardBandPlanes[RIGHT_PLANE].Normal = Vec3_New(-cos(Half_FOVx), 0, sin(Half_FOVx));
+	GuardBandPlanes[TOP_PLANE].Normal = Vec3_New(0, -cos(Half_FOVy), sin(Half_FOVy));
+	GuardBandPlanes[BOTTOM_PLANE].Normal = Vec3_New(0, cos(Half_FOVy), sin(Half_FOVy));
+}
+
+// Half of what the rasterizer accepts, so snapping or rounding can never push a clipped triangle past the limit
+static float Get_Guard_Band_Scale(int ScreenSize)
+{
+	return fmaxf(1.0f, (RASTER_MAX_EXTENT / 2.0f) / ScreenSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Clip space planes, as (x, y, z, w) coefficients
+///////////////////////////////////////////////////////////////////////////////
+void Initialize_Clip_Space_Planes(int ScreenWidth, int ScreenHeight)
+{
+	const float PlaneCoefficients[NUM_CLIP_SPACE_PLANES][4] =
+	{
+		[LEFT_PLANE] = { 1, 0, 0, 1 },
+		[RIGHT_PLANE] = { -1, 0, 0, 1 },
+		[TOP_PLANE] = { 0, -1, 0, 1 },
+		[BOTTOM_PLANE] = { 0, 1, 0, 1 },
+		[NEAR_PLANE] = { 0, 0, 1, 0 },
+		[FAR_PLANE] = { 0, 0, -1, 1 },
+		[GUARD_BAND_OUTCODE_SHIFT + LEFT_PLANE] = { 1, 0, 0, Get_Guard_Band_Scale(ScreenWidth) },
+		[GUARD_BAND_OUTCODE_SHIFT + RIGHT_PLANE] = { -1, 0, 0, Get_Guard_Band_Scale(ScreenWidth) },
+		[GUARD_BAND_OUTCODE_SHIFT + TOP_PLANE] = { 0, -1, 0, Get_Guard_Band_Scale(ScreenHeight) },
+		[GUARD_BAND_OUTCODE_SHIFT + BOTTOM_PLANE] = { 0, 1, 0, Get_Guard_Band_Scale(ScreenHeight) },
+		// Padding: the distance is w, and their outcode bits are never used
+		[GUARD_BAND_OUTCODE_SHIFT + NUM_GUARD_BAND_PLANES] = { 0, 0, 0, 1 },
+		[GUARD_BAND_OUTCODE_SHIFT + NUM_GUARD_BAND_PLANES + 1] = { 0, 0, 0, 1 }
+	};
+
+	for (int PlaneIndex = 0; PlaneIndex < NUM_CLIP_SPACE_PLANES; PlaneIndex++)
+	{
+		ClipSpacePlanes.X[PlaneIndex] = PlaneCoefficients[PlaneIndex][0];
+		ClipSpacePlanes.Y[PlaneIndex] = PlaneCoefficients[PlaneIndex][1];
+		ClipSpacePlanes.Z[PlaneIndex] = PlaneCoefficients[PlaneIndex][2];
+		ClipSpacePlanes.W[PlaneIndex] = PlaneCoefficients[PlaneIndex][3];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Outcodes
+///////////////////////////////////////////////////////////////////////////////
+
+int Get_Vertex_Outcode(vec4_t Vertex)
+{
+	vec3_t Point = Vec4_To_Vec3(Vertex);
+	int Outcode = 0;
+
+	// Same test as the clipping: a vertex is only inside when the dot product is positive
+	for (int PlaneIndex = 0; PlaneIndex < NUM_FRUSTRUM_PLANES; PlaneIndex++)
+	{
+		if (Vec3_Dot(Vec3_Subtract(Point, FrustrumPlanes[PlaneIndex].Point), FrustrumPlanes[PlaneIndex].Normal) <= 0.0)
+		{
+			Outcode |= 1 << PlaneIndex;
+		}
+	}
+	for (int PlaneIndex = 0; PlaneIndex < NUM_GUARD_BAND_PLANES; PlaneIndex++)
+	{
+		if (Vec3_Dot(Vec3_Subtract(Point, GuardBandPlanes[PlaneIndex].Point), GuardBandPlanes[PlaneIndex].Normal) <= 0.0)
+		{
+			Outcode |= 1 << (GUARD_BAND_OUTCODE_SHIFT + PlaneIndex);
+		}
+	}
+	return Outcode;
+}
+
+int Classify_Triangle(const vec4_t Vertices[3])
+{
+	int Outcode0 = Get_Vertex_Outcode(Vertices[0]);
+	int Outcode1 = Get_Vertex_Outcode(Vertices[1]);
+	int Outcode2 = Get_Vertex_Outcode(Vertices[2]);
+	return Classify_Outcodes(Outcode0, Outcode1, Outcode2);
+}
+
+int Classify_Clip_Polygon(const clip_polygon_t* Polygon)
+{
+	const clip_vertex_buffer_t* Vertices = &Polygon->Buffers[Polygon->Current];
+	return Classify_Outcodes(Vertices->Outcodes[0], Vertices->Outcodes[1], Vertices->Outcodes[2]);
+}
+
+static int Classify_Outcodes(int Outcode0, int Outcode1, int Outcode2)
+{
+	if ((Outcode0 & Outcode1 & Outcode2 & FRUSTRUM_OUTCODE_MASK) != 0)
+	{
+		return TRIANGLE_REJECTED;
+	}
+
+	int ClipMask = Is_Guard_Band_Clipping() ? (NEAR_FAR_OUTCODE_MASK | GUARD_BAND_OUTCODE_MASK) : FRUSTRUM_OUTCODE_MASK;
+	if (((Outcode0 | Outcode1 | Outcode2) & ClipMask) == 0)
+	{
+		return TRIANGLE_ACCEPTED;
+	}
+	return TRIANGLE_CLIPPED;
+}
+
 float Float_Lerp(float a, float b, float factor)
 {
 	return (a + (factor * (b-a) ) );
@@ -89,19 +250,85 @@ polygon_t Polygon_From_Triangle(
 ///////////////////////////////////////////////////////////////////////////////
 void Clip_Polygon(polygon_t * Polygon)
 {
-	// The resulting output polygon of one clipping stage is used as the input for the next one
-	Clip_Polygon_Against_Plane(Polygon, LEFT_PLANE);
-	Clip_Polygon_Against_Plane(Polygon, RIGHT_PLANE);
-	Clip_Polygon_Against_Plane(Polygon, TOP_PLANE);
-	Clip_Polygon_Against_Plane(Polygon, BOTTOM_PLANE);
-	Clip_Polygon_Against_Plane(Polygon, NEAR_PLANE);
-	Clip_Polygon_Against_Plane(Polygon, FAR_PLANE);
+	if (!Is_Guard_Band_Clipping())
+	{
+		// The resulting output polygon of one clipping stage is used as the input for the next one
+		Clip_Polygon_Against_Plane(Polygon, LEFT_PLANE);
+		Clip_Polygon_Against_Plane(Polygon, RIGHT_PLANE);
+		Clip_Polygon_Against_Plane(Polygon, TOP_PLANE);
+		Clip_Polygon_Against_Plane(Polygon, BOTTOM_PLANE);
+		Clip_Polygon_Against_Plane(Polygon, NEAR_PLANE);
+		Clip_Polygon_Against_Plane(Polygon, FAR_PLANE);
+		return;
+	}
+
+	// A polygon completely outside one of the side planes can't be seen at all
+	for (int PlaneIndex = LEFT_PLANE; PlaneIndex <= BOTTOM_PLANE; PlaneIndex++)
+	{
+		if (Get_Polygon_Side(Polygon, &FrustrumPlanes[PlaneIndex]) == POLYGON_OUTSIDE)
+		{
+			Polygon->NumVertices = 0;
+			return;
+		}
+	}
+
+	// Near and far are always clipped: the projection breaks behind the camera, and the depth must stay in range
+	// The side planes are only clipped against the guard band, the rest is scissored by the rasterizer (the bounding
+	// box of the triangle is clamped to the screen), so most triangles crossing the screen borders skip clipping
+	Clip_Polygon_If_Crossing(Polygon, &FrustrumPlanes[NEAR_PLANE]);
+	Clip_Polygon_If_Crossing(Polygon, &FrustrumPlanes[FAR_PLANE]);
+	for (int PlaneIndex = LEFT_PLANE; PlaneIndex <= BOTTOM_PLANE; PlaneIndex++)
+	{
+		Clip_Polygon_If_Crossing(Polygon, &GuardBandPlanes[PlaneIndex]);
+	}
+}
+
+// Only the edge function rasterizer clamps the triangles to the screen before looping their pixels
+static bool Is_Guard_Band_Clipping(void)
+{
+	return Is_Guard_Band() && Is_Raster_Edge_Function();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Find if all the vertices of the polygon are inside or outside the plane
+///////////////////////////////////////////////////////////////////////////////
+static int Get_Polygon_Side(const polygon_t* Polygon, const plane_t* Plane)
+{
+	int NumInside = 0;
+	for (int idx = 0; idx < Polygon->NumVertices; idx++)
+	{
+		// Same test as the clipping: inside when the dot product is positive
+		if (Vec3_Dot(Vec3_Subtract(Polygon->Vertices[idx], Plane->Point), Plane->Normal) > 0.0)
+		{
+			NumInside++;
+		}
+	}
+
+	if (NumInside == Polygon->NumVertices)
+	{
+		return POLYGON_INSIDE;
+	}
+	return (NumInside == 0) ? POLYGON_OUTSIDE : POLYGON_CROSSING;
+}
+
+// Clipping a polygon that's completely inside the plane gives back the same polygon, so only clip the crossing ones
+static void Clip_Polygon_If_Crossing(polygon_t* Polygon, const plane_t* Plane)
+{
+	if (Polygon->NumVertices > 0 && Get_Polygon_Side(Polygon, Plane) != POLYGON_INSIDE)
+	{
+		Clip_Polygon_Against(Polygon, Plane);
+	}
 }
 
 void Clip_Polygon_Against_Plane(polygon_t * Polygon, int PlaneIndex)
 {
-	vec3_t PlanePoint = FrustrumPlanes[PlaneIndex].Point;
-	vec3_t PlaneNormal = FrustrumPlanes[PlaneIndex].Normal;
+	Clip_Polygon_Against(Polygon, &FrustrumPlanes[PlaneIndex]);
+}
+
+static void Clip_Polygon_Against(polygon_t * Polygon, const plane_t* Plane)
+{
+	vec3_t PlanePoint = Plane->Point;
+	vec3_t PlaneNormal = Plane->Normal;
 	
 	// Declare the static array of Inside vertices and texture coords that will be part of the final clipped polygon returned
 	vec3_t InsideVerts[MAX_NUM_POLYGON_VERTICES];
@@ -210,3 +437,253 @@ void Triangles_From_Polygon(polygon_t * Polygon, Triangle_t Triangles[], int * N
 
 	*NumTriangles = Polygon->NumVertices - 2;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// Homogeneous clip space clipping
+///////////////////////////////////////////////////////////////////////////////
+// The distance to a plane is a linear function of (x, y, z, w), so the
+// distances of an intersection point are the lerp of the distances of the
+// edge's endpoints. Only the vertices of the original triangle need the dot
+// products, and the clipping never goes back to camera space
+///////////////////////////////////////////////////////////////////////////////
+
+// Distances of the vertex to all the clip space planes
+static void Get_Clip_Space_Distances(const vec4_t* Vertex, float Distances[NUM_CLIP_SPACE_PLANES])
+{
+#if defined(CLIP_SPACE_SIMD)
+	__m128 X = _mm_set1_ps(Vertex->x);
+	__m128 Y = _mm_set1_ps(Vertex->y);
+	__m128 Z = _mm_set1_ps(Vertex->z);
+	__m128 W = _mm_set1_ps(Vertex->w);
+	for (int PlaneIndex = 0; PlaneIndex < NUM_CLIP_SPACE_PLANES; PlaneIndex += 4)
+	{
+		__m128 Distance = _mm_mul_ps(X, _mm_loadu_ps(&ClipSpacePlanes.X[PlaneIndex]));
+		Distance = _mm_add_ps(Distance, _mm_mul_ps(Y, _mm_loadu_ps(&ClipSpacePlanes.Y[PlaneIndex])));
+		Distance = _mm_add_ps(Distance, _mm_mul_ps(Z, _mm_loadu_ps(&ClipSpacePlanes.Z[PlaneIndex])));
+		Distance = _mm_add_ps(Distance, _mm_mul_ps(W, _mm_loadu_ps(&ClipSpacePlanes.W[PlaneIndex])));
+		_mm_storeu_ps(&Distances[PlaneIndex], Distance);
+	}
+#else
+	for (int PlaneIndex = 0; PlaneIndex < NUM_CLIP_SPACE_PLANES; PlaneIndex++)
+	{
+		Distances[PlaneIndex] = Vertex->x * ClipSpacePlanes.X[PlaneIndex] + Vertex->y * ClipSpacePlanes.Y[PlaneIndex] +
+			Vertex->z * ClipSpacePlanes.Z[PlaneIndex] + Vertex->w * ClipSpacePlanes.W[PlaneIndex];
+	}
+#endif
+}
+
+// Outcode bits of the planes the vertex isn't inside of (same test as the clipping: inside only when positive)
+static int Get_Clip_Space_Outcode(const float Distances[NUM_CLIP_SPACE_PLANES])
+{
+	int Outcode = 0;
+#if defined(CLIP_SPACE_SIMD)
+	for (int PlaneIndex = 0; PlaneIndex < NUM_CLIP_SPACE_PLANES; PlaneIndex += 4)
+	{
+		__m128 Outside = _mm_cmple_ps(_mm_loadu_ps(&Distances[PlaneIndex]), _mm_setzero_ps());
+		Outcode |= _mm_movemask_ps(Outside) << PlaneIndex;
+	}
+#else
+	for (int PlaneIndex = 0; PlaneIndex < NUM_CLIP_SPACE_PLANES; PlaneIndex++)
+	{
+		if (Distances[PlaneIndex] <= 0.0f)
+		{
+			Outcode |= 1 << PlaneIndex;
+		}
+	}
+#endif
+	return Outcode;
+}
+
+// Result = A + t(B - A) for the distances to all the planes
+static void Lerp_Clip_Space_Distances(const float A[NUM_CLIP_SPACE_PLANES], const float B[NUM_CLIP_SPACE_PLANES], float t,
+	float Result[NUM_CLIP_SPACE_PLANES])
+{
+#if defined(CLIP_SPACE_SIMD)
+	__m128 Factor = _mm_set1_ps(t);
+	for (int PlaneIndex = 0; PlaneIndex < NUM_CLIP_SPACE_PLANES; PlaneIndex += 4)
+	{
+		__m128 DistanceA = _mm_loadu_ps(&A[PlaneIndex]);
+		__m128 DistanceB = _mm_loadu_ps(&B[PlaneIndex]);
+		_mm_storeu_ps(&Result[PlaneIndex], _mm_add_ps(DistanceA, _mm_mul_ps(Factor, _mm_sub_ps(DistanceB, DistanceA))));
+	}
+#else
+	for (int PlaneIndex = 0; PlaneIndex < NUM_CLIP_SPACE_PLANES; PlaneIndex++)
+	{
+		Result[PlaneIndex] = Float_Lerp(A[PlaneIndex], B[PlaneIndex], t);
+	}
+#endif
+}
+
+// Set a vertex of the buffer from its position and UV, and find its distances and outcode
+static void Set_Clip_Vertex(clip_vertex_buffer_t* Vertices, int Index, const vec4_t* Position, const tex2_t* UV)
+{
+	Vertices->Components[CLIP_COMPONENT_X][Index] = Position->x;
+	Vertices->Components[CLIP_COMPONENT_Y][Index] = Position->y;
+	Vertices->Components[CLIP_COMPONENT_Z][Index] = Position->z;
+	Vertices->Components[CLIP_COMPONENT_W][Index] = Position->w;
+	Vertices->Components[CLIP_COMPONENT_U][Index] = UV->u;
+	Vertices->Components[CLIP_COMPONENT_V][Index] = UV->v;
+
+	Get_Clip_Space_Distances(Position, Vertices->Distances[Index]);
+	Vertices->Outcodes[Index] = Get_Clip_Space_Outcode(Vertices->Distances[Index]);
+}
+
+void Clip_Polygon_From_Triangle(clip_polygon_t* Polygon,
+	vec4_t* TriangleVert0, vec4_t* TriangleVert1, vec4_t* TriangleVert2,
+	tex2_t* TriangleUV0, tex2_t* TriangleUV1, tex2_t* TriangleUV2
+)
+{
+	clip_vertex_buffer_t* Vertices = &Polygon->Buffers[0];
+	Polygon->Current = 0;
+
+	Set_Clip_Vertex(Vertices, 0, TriangleVert0, TriangleUV0);
+	Set_Clip_Vertex(Vertices, 1, TriangleVert1, TriangleUV1);
+	Set_Clip_Vertex(Vertices, 2, TriangleVert2, TriangleUV2);
+	Vertices->NumVertices = 3;
+}
+
+// Same steps as Clip_Polygon_Against, but the distance to the plane is already in the vertices
+// The clipped polygon goes into the other buffer, which becomes the current one
+static void Clip_Homogeneous_Against(clip_polygon_t* Polygon, int PlaneIndex)
+{
+	const clip_vertex_buffer_t* Input = &Polygon->Buffers[Polygon->Current];
+	clip_vertex_buffer_t* Output = &Polygon->Buffers[Polygon->Current ^ 1];
+	int NumInsideVerts = 0;
+
+	int PreviousIndex = Input->NumVertices - 1;
+	float PreviousDistance = Input->Distances[PreviousIndex][PlaneIndex];
+
+	for (int CurrentIndex = 0; CurrentIndex < Input->NumVertices; CurrentIndex++)
+	{
+		float CurrentDistance = Input->Distances[CurrentIndex][PlaneIndex];
+
+		// The edge crosses the plane: add the intersection point
+		if ((CurrentDistance * PreviousDistance) < 0.0f)
+		{
+			float t = PreviousDistance / (PreviousDistance - CurrentDistance);
+
+			for (int Component = 0; Component < NUM_CLIP_COMPONENTS; Component++)
+			{
+				Output->Components[Component][NumInsideVerts] =
+					Float_Lerp(Input->Components[Component][PreviousIndex], Input->Components[Component][CurrentIndex], t);
+			}
+			Lerp_Clip_Space_Distances(Input->Distances[PreviousIndex], Input->Distances[CurrentIndex], t, Output->Distances[NumInsideVerts]);
+			Output->Outcodes[NumInsideVerts] = Get_Clip_Space_Outcode(Output->Distances[NumInsideVerts]);
+
+			NumInsideVerts++;
+		}
+
+		// The current vertex is inside the plane: keep it
+		if (CurrentDistance > 0.0f)
+		{
+			for (int Component = 0; Component < NUM_CLIP_COMPONENTS; Component++)
+			{
+				Output->Components[Component][NumInsideVerts] = Input->Components[Component][CurrentIndex];
+			}
+			memcpy(Output->Distances[NumInsideVerts], Input->Distances[CurrentIndex], sizeof(Output->Distances[0]));
+			Output->Outcodes[NumInsideVerts] = Input->Outcodes[CurrentIndex];
+
+			NumInsideVerts++;
+		}
+
+		PreviousIndex = CurrentIndex;
+		PreviousDistance = CurrentDistance;
+	}
+
+	Output->NumVertices = NumInsideVerts;
+	Polygon->Current ^= 1;
+}
+
+void Clip_Polygon_Homogeneous(clip_polygon_t* Polygon)
+{
+	// Planes used by Clip_Polygon, in the same order
+	static const int FrustrumClipOrder[] = { LEFT_PLANE, RIGHT_PLANE, TOP_PLANE, BOTTOM_PLANE, NEAR_PLANE, FAR_PLANE };
+	static const int GuardBandClipOrder[] =
+	{
+		NEAR_PLANE, FAR_PLANE,
+		GUARD_BAND_OUTCODE_SHIFT + LEFT_PLANE, GUARD_BAND_OUTCODE_SHIFT + RIGHT_PLANE,
+		GUARD_BAND_OUTCODE_SHIFT + TOP_PLANE, GUARD_BAND_OUTCODE_SHIFT + BOTTOM_PLANE
+	};
+	const int* ClipOrder = Is_Guard_Band_Clipping() ? GuardBandClipOrder : FrustrumClipOrder;
+
+	// A polygon completely outside one of the frustum planes can't be seen at all
+	const clip_vertex_buffer_t* Vertices = &Polygon->Buffers[Polygon->Current];
+	int CommonOutcode = FRUSTRUM_OUTCODE_MASK;
+	for (int Vertex = 0; Vertex < Vertices->NumVertices; Vertex++)
+	{
+		CommonOutcode &= Vertices->Outcodes[Vertex];
+	}
+	if (CommonOutcode != 0)
+	{
+		Polygon->Buffers[Polygon->Current].NumVertices = 0;
+		return;
+	}
+
+	for (int idx = 0; idx < NUM_FRUSTRUM_PLANES; idx++)
+	{
+		Vertices = &Polygon->Buffers[Polygon->Current];
+		if (Vertices->NumVertices == 0)
+		{
+			return;
+		}
+
+		// A plane no vertex is outside of would give back the same polygon
+		int CombinedOutcode = 0;
+		for (int Vertex = 0; Vertex < Vertices->NumVertices; Vertex++)
+		{
+			CombinedOutcode |= Vertices->Outcodes[Vertex];
+		}
+		if ((CombinedOutcode & (1 << ClipOrder[idx])) != 0)
+		{
+			Clip_Homogeneous_Against(Polygon, ClipOrder[idx]);
+		}
+	}
+}
+
+void Project_Clip_Polygon(clip_polygon_t* Polygon, int ScreenWidth, int ScreenHeight)
+{
+	clip_vertex_buffer_t* Vertices = &Polygon->Buffers[Polygon->Current];
+	float* X = Vertices->Components[CLIP_COMPONENT_X];
+	float* Y = Vertices->Components[CLIP_COMPONENT_Y];
+	float* Z = Vertices->Components[CLIP_COMPONENT_Z];
+	const float* W = Vertices->Components[CLIP_COMPONENT_W];
+
+	for (int idx = 0; idx < Vertices->NumVertices; idx++)
+	{
+		// Perspective divide with the original Z value stored in W
+		if (W[idx] != 0)
+		{
+			X[idx] /= W[idx];
+			Y[idx] /= W[idx];
+			Z[idx] /= W[idx];
+		}
+
+		// Scale into the view, flip the Y axis (it grows downwards on the screen) and move to the middle of the screen
+		X[idx] *= (ScreenWidth / 2.0);
+		Y[idx] *= -(ScreenHeight / 2.0);
+		X[idx] += (ScreenWidth / 2.0);
+		Y[idx] += (ScreenHeight / 2.0);
+	}
+}
+
+int Triangles_From_Clip_Polygon(const clip_polygon_t* Polygon, Triangle_t Triangles[], int MaxTriangles)
+{
+	const clip_vertex_buffer_t* Vertices = &Polygon->Buffers[Polygon->Current];
+	int NumTriangles = SDL_min(Vertices->NumVertices - 2, MaxTriangles);
+
+	for (int idx = 0; idx < NumTriangles; idx++)
+	{
+		int FanIndices[3] = { 0, idx + 1, idx + 2 };
+		for (int ind = 0; ind < 3; ind++)
+		{
+			int Vertex = FanIndices[ind];
+			Triangles[idx].vertex[ind].x = Vertices->Components[CLIP_COMPONENT_X][Vertex];
+			Triangles[idx].vertex[ind].y = Vertices->Components[CLIP_COMPONENT_Y][Vertex];
+			Triangles[idx].vertex[ind].z = Vertices->Components[CLIP_COMPONENT_Z][Vertex];
+			Triangles[idx].vertex[ind].w = Vertices->Components[CLIP_COMPONENT_W][Vertex];
+			Triangles[idx].uvCoordinates[ind].u = Vertices->Components[CLIP_COMPONENT_U][Vertex];
+			Triangles[idx].uvCoordinates[ind].v = Vertices->Components[CLIP_COMPONENT_V][Vertex];
+		}
+	}
+	return SDL_max(NumTriangles, 0);
+}
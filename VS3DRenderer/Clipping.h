@@ -20,6 +20,15 @@ enum
 	FAR_PLANE
 };
 
+// How a triangle is handled by the clipping stage, found with the outcodes of its vertices
+enum
+{
+	TRIANGLE_ACCEPTED, // Inside all the planes it would be clipped against: it goes straight to projection
+	TRIANGLE_REJECTED, // All its vertices are outside the same frustum plane: it can't be seen
+	TRIANGLE_CLIPPED, // Crossing some plane: it goes through the polygon clipper
+	NUM_TRIANGLE_CLIP_CLASSES
+};
+
 typedef struct
 {
 	vec3_t Point; // Plane's position/origin
@@ -33,6 +42,40 @@ typedef struct
 	int NumVertices;
 }polygon_t;
 
+// Clip space planes: the six frustum ones (same order as above), the four guard band sides, and two padding lanes
+// that are never clipped against, so the distances to all the planes are evaluated in groups of 4 floats
+#define NUM_CLIP_SPACE_PLANES 12
+
+// Components of a clip space vertex: the position, then every attribute interpolated along with it
+// Another attribute (a vertex color, a normal...) only needs a new entry here, the clipper lerps all of them
+enum
+{
+	CLIP_COMPONENT_X,
+	CLIP_COMPONENT_Y,
+	CLIP_COMPONENT_Z,
+	CLIP_COMPONENT_W,
+	CLIP_COMPONENT_U,
+	CLIP_COMPONENT_V,
+	NUM_CLIP_COMPONENTS
+};
+
+// Vertices of a polygon in homogeneous clip space (after the Model-View-Projection transform, before the perspective divide)
+// The components are stored SoA, and each vertex keeps its distance to every clip space plane and the outcode made from them
+typedef struct
+{
+	float Components[NUM_CLIP_COMPONENTS][MAX_NUM_POLYGON_VERTICES];
+	float Distances[MAX_NUM_POLYGON_VERTICES][NUM_CLIP_SPACE_PLANES];
+	int Outcodes[MAX_NUM_POLYGON_VERTICES];
+	int NumVertices;
+}clip_vertex_buffer_t;
+
+// Each plane reads the vertices from one buffer and writes the clipped ones into the other, so nothing is copied back
+typedef struct
+{
+	clip_vertex_buffer_t Buffers[2];
+	int Current; // Buffer with the current vertices of the polygon
+}clip_polygon_t;
+
 ///////////////////////////////////////////////////////////////////////////////
 // Initialize the Frustum planes (defined by a point and a normal vector)
 ///////////////////////////////////////////////////////////////////////////////
@@ -45,6 +88,50 @@ typedef struct
 ///////////////////////////////////////////////////////////////////////////////
 void Initialize_Frustrum_Planes(float FOVx, float FOVy, float ZNear, float ZFar);
 
+///////////////////////////////////////////////////////////////////////////////
+// Initialize the side planes of the guard band: a frustum as wide as possible
+// while the clipped triangles still fit in the rasterizer (RASTER_MAX_EXTENT)
+///////////////////////////////////////////////////////////////////////////////
+// With the guard band enabled, the triangles are only clipped against the
+// near/far planes and the guard band. The part that's outside the screen but
+// inside the guard band is skipped by the rasterizer, which is much cheaper
+// than clipping it
+///////////////////////////////////////////////////////////////////////////////
+void Initialize_Guard_Band_Planes(float FOVx, float FOVy, int ScreenWidth, int ScreenHeight);
+
+///////////////////////////////////////////////////////////////////////////////
+// Outcode of a vertex in camera space: one bit for each plane it's outside of
+///////////////////////////////////////////////////////////////////////////////
+// Bits 0 to 5 are the frustum planes (LEFT_PLANE to FAR_PLANE), and bits 6 to 9
+// the side planes of the guard band
+///////////////////////////////////////////////////////////////////////////////
+int Get_Vertex_Outcode(vec4_t Vertex);
+
+///////////////////////////////////////////////////////////////////////////////
+// Classify a triangle in camera space before building any polygon
+///////////////////////////////////////////////////////////////////////////////
+// If the outcodes of all the vertices share a frustum bit, they are all outside
+// that plane and the triangle is rejected. If none of them has a bit of the
+// planes Clip_Polygon would use (which depend on the guard band), clipping
+// would give back the same triangle, so it's accepted as is
+///////////////////////////////////////////////////////////////////////////////
+int Classify_Triangle(const vec4_t Vertices[3]);
+
+///////////////////////////////////////////////////////////////////////////////
+// Initialize the planes of the homogeneous clip space
+///////////////////////////////////////////////////////////////////////////////
+// After the projection, the visible volume is -w < x < w, -w < y < w and
+// 0 < z < w whatever the FOV or the near/far distances are, so the distance
+// to each plane is just a dot product with (x, y, z, w):
+// Left   : w + x      Guard band left   : GuardBandScaleX * w + x
+// Right  : w - x      Guard band right  : GuardBandScaleX * w - x
+// Top    : w - y      Guard band top    : GuardBandScaleY * w - y
+// Bottom : w + y      Guard band bottom : GuardBandScaleY * w + y
+// Near   : z
+// Far    : w - z
+///////////////////////////////////////////////////////////////////////////////
+void Initialize_Clip_Space_Planes(int ScreenWidth, int ScreenHeight);
+
 // A point Q will be "ON" the plane if Dot( Vector(Q-P), PlaneNormal ) = 0 (the subtracted vector is perpendicular to the normal)
 // A point Q will be in the "OUTSIDE" space made by the plane if Dot( Vector(Q-P), PlaneNormal ) < 0
 // A point Q will be in the "INSIDE" space made by the plane if Dot( Vector(Q-P), PlaneNormal ) > 0
@@ -73,4 +160,35 @@ void Clip_Polygon_Against_Plane(polygon_t* Polygon, int PlaneIndex);
 
 void Triangles_From_Polygon(polygon_t* Polygon, Triangle_t Triangles[], int* NumTriangles);
 
+///////////////////////////////////////////////////////////////////////////////
+// Load a triangle already multiplied by the MVP into a clip space polygon
+///////////////////////////////////////////////////////////////////////////////
+// The distances of each vertex to all the planes are computed here, with SIMD
+// (4 planes at a time), and reused by the classification and the clipping.
+// The polygon is meant to be declared once and reused for every triangle
+///////////////////////////////////////////////////////////////////////////////
+void Clip_Polygon_From_Triangle(clip_polygon_t* Polygon,
+	vec4_t* TriangleVert0, vec4_t* TriangleVert1, vec4_t* TriangleVert2,
+	tex2_t* TriangleUV0, tex2_t* TriangleUV1, tex2_t* TriangleUV2
+);
+
+// Same as Classify_Triangle, with the outcodes of the clip space polygon
+int Classify_Clip_Polygon(const clip_polygon_t* Polygon);
+
+///////////////////////////////////////////////////////////////////////////////
+// Clip the polygon against the w-relative planes, in place
+///////////////////////////////////////////////////////////////////////////////
+// Uses the same planes as Clip_Polygon (near/far and the guard band, or the
+// six frustum planes), skipping the ones no vertex is outside of
+///////////////////////////////////////////////////////////////////////////////
+void Clip_Polygon_Homogeneous(clip_polygon_t* Polygon);
+
+// Perspective divide and viewport transform of the clipped vertices, once for each vertex instead of once per triangle
+// Like Mat4_Multiply_Vec4_Projection, w keeps the camera space Z value
+void Project_Clip_Polygon(clip_polygon_t* Polygon, int ScreenWidth, int ScreenHeight);
+
+// Write the triangle fan of the projected polygon straight into the output triangles (up to MaxTriangles of them)
+// Only the vertices and the UVs are written, returns the number of triangles
+int Triangles_From_Clip_Polygon(const clip_polygon_t* Polygon, Triangle_t Triangles[], int MaxTriangles);
+
 #endif // !CLIPPING_H
@@ -0,0 +1,113 @@
+#include <stdint.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "Array.h"
+#include "DepthSort.h"
+
+#define SORT_KEY_BITS 16
+#define SORT_RADIX_BITS 8
+#define SORT_RADIX_SIZE (1 << SORT_RADIX_BITS)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scratch memory, kept between frames so sorting doesn't allocate (dynamic arrays, they only grow)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static float* ClosestW = NULL; // View depth of the closest vertex of each triangle
+static uint16_t* Keys = NULL; // Quantized ClosestW of each triangle
+static int* Order = NULL; // Triangle indices, sorted by the digits processed so far
+static int* NextOrder = NULL; // Triangle indices after sorting by the current digit
+static Triangle_t* SortedTriangles = NULL;
+
+// Make room for Count elements in a dynamic array, throwing away its previous contents
+static void* Resize_Scratch(void* Array, int Count, int ItemSize)
+{
+	Array_Clear(Array);
+	return Array_Hold(Array, Count, ItemSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Sort_Triangles_Front_To_Back(Triangle_t* Triangles, int NumTriangles)
+{
+	if (NumTriangles < 2)
+	{
+		return;
+	}
+
+	ClosestW = Resize_Scratch(ClosestW, NumTriangles, sizeof(*ClosestW));
+	Keys = Resize_Scratch(Keys, NumTriangles, sizeof(*Keys));
+	Order = Resize_Scratch(Order, NumTriangles, sizeof(*Order));
+	NextOrder = Resize_Scratch(NextOrder, NumTriangles, sizeof(*NextOrder));
+	SortedTriangles = Resize_Scratch(SortedTriangles, NumTriangles, sizeof(*SortedTriangles));
+
+	// W is the view depth of each vertex (the projection keeps the original Z there), positive after clipping
+	float MinW = FLT_MAX;
+	float MaxW = -FLT_MAX;
+	for (int idx = 0; idx < NumTriangles; idx++)
+	{
+		const vec4_t* Vertex = Triangles[idx].vertex;
+		float W = fminf(Vertex[0].w, fminf(Vertex[1].w, Vertex[2].w));
+
+		ClosestW[idx] = W;
+		MinW = fminf(MinW, W);
+		MaxW = fmaxf(MaxW, W);
+	}
+
+	// Spread the depth range of this frame over all the values of the key
+	float Scale = (MaxW > MinW) ? (float)((1 << SORT_KEY_BITS) - 1) / (MaxW - MinW) : 0.0f;
+	for (int idx = 0; idx < NumTriangles; idx++)
+	{
+		Keys[idx] = (uint16_t)((ClosestW[idx] - MinW) * Scale);
+		Order[idx] = idx;
+	}
+
+	// Least significant digit first: each pass is stable, so it keeps the order of the previous digits for equal digits
+	for (int Shift = 0; Shift < SORT_KEY_BITS; Shift += SORT_RADIX_BITS)
+	{
+		int Offsets[SORT_RADIX_SIZE + 1] = { 0 };
+
+		// Count how many keys have each digit, then turn the counts into the first position of each digit
+		for (int idx = 0; idx < NumTriangles; idx++)
+		{
+			Offsets[((Keys[idx] >> Shift) & (SORT_RADIX_SIZE - 1)) + 1]++;
+		}
+		for (int Digit = 1; Digit <= SORT_RADIX_SIZE; Digit++)
+		{
+			Offsets[Digit] += Offsets[Digit - 1];
+		}
+
+		for (int idx = 0; idx < NumTriangles; idx++)
+		{
+			int Triangle = Order[idx];
+			NextOrder[Offsets[(Keys[Triangle] >> Shift) & (SORT_RADIX_SIZE - 1)]++] = Triangle;
+		}
+
+		int* Swap = Order;
+		Order = NextOrder;
+		NextOrder = Swap;
+	}
+
+	// Only the indices were moved during the passes, the triangles are much bigger so they're moved once
+	for (int idx = 0; idx < NumTriangles; idx++)
+	{
+		SortedTriangles[idx] = Triangles[Order[idx]];
+	}
+	memcpy(Triangles, SortedTriangles, NumTriangles * sizeof(*Triangles));
+}
+
+void Destroy_Depth_Sort(void)
+{
+	Array_Free(ClosestW);
+	Array_Free(Keys);
+	Array_Free(Order);
+	Array_Free(NextOrder);
+	Array_Free(SortedTriangles);
+	ClosestW = NULL;
+	Keys = NULL;
+	Order = NULL;
+	NextOrder = NULL;
+	SortedTriangles = NULL;
+}
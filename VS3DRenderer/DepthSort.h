@@ -0,0 +1,28 @@
+#pragma once
+
+#ifndef DEPTH_SORT_H
+#define DEPTH_SORT_H
+
+#include "Triangle.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Front-to-back ordering of the triangles to render
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	The triangles come out of the pipeline in mesh/face order, so the ones at the back are often shaded first and
+	then covered by the ones in front of them. Drawing the closest ones first lets the depth test (and the
+	hierarchical Z) reject the hidden pixels before they're shaded.
+
+	Each triangle gets a 16 bits key with the view depth (W) of its closest vertex, quantized between the closest
+	and the farthest triangle of the frame, and they're sorted with a radix sort of 2 passes of 8 bits. It's stable,
+	so triangles with the same key keep their order, and it takes the same time no matter how they're ordered.
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Reorder the triangles from the closest to the farthest
+void Sort_Triangles_Front_To_Back(Triangle_t* Triangles, int NumTriangles);
+
+// Free the memory used to sort
+void Destroy_Depth_Sort(void);
+
+#endif // !DEPTH_SORT_H
@@ -1,9 +1,24 @@
 #include <stdio.h>
+#include <string.h>
 #include <stdint.h> // For the new fixed types
 #include <stdbool.h>
 #include <SDL.h>
 #include "Display.h"
 
+// The clears use non-temporal stores: the buffers are much bigger than the caches, and the rasterizer only gets back to
+// each pixel much later, so there's no point in reading the old lines into the caches just to overwrite them
+// (the detiling of the tiled framebuffer uses the same registers to copy a row of a tile at once, and the tiles with
+// their own buffers write them back to the screen with the same streaming stores)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CLEAR_SIMD_AVX2
+#define CLEAR_SIMD_ALIGNMENT 32
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLEAR_SIMD_SSE2
+#define CLEAR_SIMD_ALIGNMENT 16
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Global Variables
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -23,15 +38,61 @@ static color_t* ColorBuffer = NULL; // Declare a pointer to the 1st position of
 
 static SDL_Texture* ColorBufferTexture = NULL; // SDL Texture used to display the Color Buffer
 
-static float* ZBuffer = NULL; // Array containing the depth value of each pixel that'll be rendered
+static void* ZBuffer = NULL; // Array containing the depth value of each pixel that'll be rendered
+static int DepthFormat = DEPTH_FORMAT_FLOAT32; // What's in each element of the ZBuffer, see EDepth_Format
+
+// Coarse depth buffer: the farthest depth of each DEPTH_BLOCK_SIZE x DEPTH_BLOCK_SIZE block of the ZBuffer
+// It can be bigger than the real farthest depth (the rasterizer only lowers it after drawing whole blocks), but never smaller,
+// so anything farther than it is guaranteed to be hidden by what's already in the block
+static float* ZBufferBlockMax = NULL;
+static int DepthBlocksX = 0;
+static int DepthBlocksY = 0;
+static bool bHierarchicalZ = true;
+
+// Visibility buffer: the ID of the triangle that covers each pixel (0 when there's none), for the deferred texturing
+static uint32_t* VisibilityBuffer = NULL;
+static bool bVisibilityBuffer = false;
+static bool bSpanBuffer = false;
+static bool bDepthPrepass = false;
+static bool bFrontToBack = true;
+static bool bSpecializedRenderers = true;
+static bool bGuardBand = true;
+static bool bClipSpaceClipping = true;
+static int PerspectiveSpanLength = PERSPECTIVE_SPAN_EXACT;
+static bool bClearElision = true;
+static bool bDepthGenerations = false;
+static int DepthGeneration = 0; // 0 is the frame that clears the ZBuffer, see DEPTH_GENERATIONS
+static bool bZBufferClearSkipped = false; // Some frame kept its depths in the tile buffers, see Skip_ZBuffer_Clear
+static bool bTileBuffers = false;
+static float DepthMaxReciprocalW = 10.0f; // 1/ZNear, see Set_Near_Plane
+static float DepthGenerationSpacing = 16.0f; // See DEPTH_GENERATIONS
 
 static int WindowWidth = 320; //800;
 static int WindowHeight = 200; //600;
+static int BufferWidth = 320; // WindowWidth, padded to whole tiles with TILED_FRAMEBUFFER
+static int BufferHeight = 200;
+
+static render_target_t ScreenTarget; // The buffers above, for the rasterizers
 
 static int CullMode = CULL_BACKFACE;
 
 static int RenderMode = RENDER_WIRE;
 
+// The parts drawn by each render mode, from RENDER_MODE_LIST
+typedef struct
+{
+	bool bFill;
+	bool bTextured;
+	bool bWireframe;
+	bool bVertices;
+}render_mode_parts_t;
+
+#define RENDER_MODE_PARTS(Mode, Name, bFill, bTextured, bWireframe, bVertices) [Mode] = { bFill, bTextured, bWireframe, bVertices },
+static const render_mode_parts_t RenderModeParts[NUM_RENDER_MODES] = { RENDER_MODE_LIST(RENDER_MODE_PARTS) };
+
+static int RasterMode = RASTER_SCANLINE;
+static int ParallelMode = PARALLEL_NONE;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Getters/Setters
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,13 +107,34 @@ int Get_Window_Height(void)
 	return WindowHeight;
 }
 
+int Get_Buffer_Width(void)
+{
+	return BufferWidth;
+}
+
+int Get_Buffer_Height(void)
+{
+	return BufferHeight;
+}
+
 float Get_ZBuffer_At(int x, int y)
 {
 	if (x < 0 || x >= WindowWidth || y < 0 || y >= WindowHeight)
 	{
 		return 1.0;
 	}
-	return ZBuffer[(WindowWidth*y)+x];
+
+	// The integer formats are turned back into 1 - 1/W (there are no depth generations with them, so the bias is always 1)
+	int Index = Pixel_Row_Offset(y, BufferWidth) + Pixel_Column_Offset(x);
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_UNORM16:
+		return 1.0f - ((DEPTH_UNORM16_MAX - ((uint16_t*)ZBuffer)[Index]) * (DepthMaxReciprocalW / DEPTH_UNORM16_MAX));
+	case DEPTH_FORMAT_UNORM24:
+		return 1.0f - ((DEPTH_UNORM24_MAX - ((uint32_t*)ZBuffer)[Index]) * (DepthMaxReciprocalW / DEPTH_UNORM24_MAX));
+	default:
+		return ((float*)ZBuffer)[Index];
+	}
 }
 
 void Update_ZBuffer_At(int x, int y, float value)
@@ -61,7 +143,53 @@ void Update_ZBuffer_At(int x, int y, float value)
 	{
 		return;
 	}
-	ZBuffer[(WindowWidth*y) + x] = value;
+
+	// The integer formats quantize the 1/W back out of the 1 - 1/W depth
+	int Index = Pixel_Row_Offset(y, BufferWidth) + Pixel_Column_Offset(x);
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_UNORM16:
+		((uint16_t*)ZBuffer)[Index] = (uint16_t)Quantize_Depth(1.0f - value, Get_Depth_Scale(), DEPTH_UNORM16_MAX);
+		break;
+	case DEPTH_FORMAT_UNORM24:
+		((uint32_t*)ZBuffer)[Index] = Quantize_Depth(1.0f - value, Get_Depth_Scale(), DEPTH_UNORM24_MAX);
+		break;
+	default:
+		((float*)ZBuffer)[Index] = value;
+		break;
+	}
+}
+
+// Direct access to the buffers, so the rasterizers can step a pointer along each row instead of calling
+// Draw_Pixel/Get_ZBuffer_At/Update_ZBuffer_At (and their bounds checks) for every single pixel
+color_t* Get_ColorBuffer(void)
+{
+	return ColorBuffer;
+}
+
+void* Get_ZBuffer(void)
+{
+	return ZBuffer;
+}
+
+uint32_t* Get_Visibility_Buffer(void)
+{
+	return VisibilityBuffer;
+}
+
+float* Get_ZBuffer_Block_Max(void)
+{
+	return ZBufferBlockMax;
+}
+
+int Get_Depth_Blocks_Per_Row(void)
+{
+	return DepthBlocksX;
+}
+
+const render_target_t* Get_Screen_Target(void)
+{
+	return &ScreenTarget;
 }
 
 void Set_Render_Mode(int Mode)
@@ -74,6 +202,87 @@ void Set_Cull_Mode(int Mode)
 	CullMode = Mode;
 }
 
+void Set_Raster_Mode(int Mode)
+{
+	RasterMode = Mode;
+}
+
+void Set_Parallel_Mode(int Mode)
+{
+	ParallelMode = Mode;
+}
+
+void Set_Hierarchical_Z(bool bEnable)
+{
+	bHierarchicalZ = bEnable;
+}
+
+void Set_Depth_Prepass(bool bEnable)
+{
+	bDepthPrepass = bEnable;
+}
+
+void Set_Visibility_Buffer(bool bEnable)
+{
+	bVisibilityBuffer = bEnable;
+}
+
+void Set_Span_Buffer(bool bEnable)
+{
+	bSpanBuffer = bEnable;
+}
+
+void Set_Guard_Band(bool bEnable)
+{
+	bGuardBand = bEnable;
+}
+
+void Set_Clip_Space_Clipping(bool bEnable)
+{
+	bClipSpaceClipping = bEnable;
+}
+
+void Set_Front_To_Back(bool bEnable)
+{
+	bFrontToBack = bEnable;
+}
+
+void Set_Specialized_Renderers(bool bEnable)
+{
+	bSpecializedRenderers = bEnable;
+}
+
+void Set_Perspective_Span_Length(int Length)
+{
+	PerspectiveSpanLength = Length;
+}
+
+void Set_Clear_Elision(bool bEnable)
+{
+	bClearElision = bEnable;
+}
+
+void Set_Depth_Generations(bool bEnable)
+{
+	bDepthGenerations = bEnable;
+}
+
+void Set_Tile_Buffers(bool bEnable)
+{
+	bTileBuffers = bEnable;
+}
+
+void Set_Near_Plane(float ZNear)
+{
+	DepthMaxReciprocalW = 1.0f / ZNear;
+	// A power of two keeps the biases whole numbers, so they don't round the 1/W subtracted from them any further
+	DepthGenerationSpacing = 1.0f;
+	while (DepthGenerationSpacing <= DepthMaxReciprocalW)
+	{
+		DepthGenerationSpacing *= 2.0f;
+	}
+}
+
 bool Is_Cull_Backface(void)
 {
 	if (CullMode == CULL_BACKFACE)
@@ -83,36 +292,190 @@ bool Is_Cull_Backface(void)
 	return false;
 }
 
+bool Is_Cull_Screen_Area(void)
+{
+	return (CullMode == CULL_SCREEN_AREA);
+}
+
+int Get_Render_Mode(void)
+{
+	return RenderMode;
+}
+
 bool Should_Render_Fill_Triangles(void)
 {
-	return (RenderMode == RENDER_FILL_TRIANGLE || RenderMode == RENDER_FILL_TRIANGLE_WIRE);
+	return RenderModeParts[RenderMode].bFill;
 }
 
 bool Should_Render_Wireframe_Triangles(void)
 {
-	return (RenderMode == RENDER_WIRE ||
-		RenderMode == RENDER_WIRE_VERTEX ||
-		RenderMode == RENDER_FILL_TRIANGLE_WIRE ||
-		RenderMode == RENDER_TEXTURED_WIRE
-		);
+	return RenderModeParts[RenderMode].bWireframe;
 }
 
 bool Should_Render_Textured_Triangles(void)
 {
-	return (RenderMode == RENDER_TEXTURED || RenderMode == RENDER_TEXTURED_WIRE);
+	return RenderModeParts[RenderMode].bTextured;
 }
 
 bool Should_Render_Triangle_Vertices(void)
 {
-	return (RenderMode == RENDER_WIRE_VERTEX);
+	return RenderModeParts[RenderMode].bVertices;
+}
+
+bool Is_Raster_Edge_Function(void)
+{
+	return (RasterMode == RASTER_EDGE_FUNCTION || RasterMode == RASTER_EDGE_FUNCTION_SIMD);
+}
+
+bool Is_Raster_SIMD(void)
+{
+	return (RasterMode == RASTER_EDGE_FUNCTION_SIMD);
+}
+
+const char* Get_Raster_Mode_Name(void)
+{
+	switch (RasterMode)
+	{
+	case RASTER_SCANLINE:
+		return "scanline";
+	case RASTER_EDGE_FUNCTION:
+		return "edge function";
+	case RASTER_EDGE_FUNCTION_SIMD:
+		return "edge function SIMD";
+	default:
+		return "unknown";
+	}
+}
+
+bool Is_Parallel_Tiles(void)
+{
+	return (ParallelMode == PARALLEL_TILES);
+}
+
+bool Is_Parallel_Interleaved(void)
+{
+	return (ParallelMode == PARALLEL_INTERLEAVED);
+}
+
+bool Is_Hierarchical_Z(void)
+{
+	// The coarse blocks keep float depths, they only work with the float depth buffer
+	return bHierarchicalZ && (DepthFormat == DEPTH_FORMAT_FLOAT32);
+}
+
+bool Is_Depth_Prepass(void)
+{
+	return bDepthPrepass;
+}
+
+bool Is_Visibility_Buffer(void)
+{
+	return bVisibilityBuffer;
+}
+
+bool Is_Span_Buffer(void)
+{
+	return bSpanBuffer;
+}
+
+bool Is_Guard_Band(void)
+{
+	return bGuardBand;
+}
+
+bool Is_Clip_Space_Clipping(void)
+{
+	return bClipSpaceClipping;
+}
+
+bool Is_Front_To_Back(void)
+{
+	return bFrontToBack;
+}
+
+bool Is_Specialized_Renderers(void)
+{
+	return bSpecializedRenderers;
+}
+
+int Get_Perspective_Span_Length(void)
+{
+	return PerspectiveSpanLength;
+}
+
+bool Is_Clear_Elision(void)
+{
+	return bClearElision;
+}
+
+bool Is_Depth_Generations(void)
+{
+	return bDepthGenerations;
+}
+
+bool Is_Tile_Buffers(void)
+{
+	return bTileBuffers;
+}
+
+float Get_Depth_Bias(void)
+{
+	return 1.0f - (DepthGeneration * DepthGenerationSpacing);
+}
+
+float Get_Depth_Scale(void)
+{
+	uint32_t MaxValue = (DepthFormat == DEPTH_FORMAT_UNORM16) ? DEPTH_UNORM16_MAX : DEPTH_UNORM24_MAX;
+	return (float)MaxValue / DepthMaxReciprocalW;
+}
+
+int Get_Depth_Format(void)
+{
+	return DepthFormat;
+}
+
+const char* Get_Depth_Format_Name(void)
+{
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_FLOAT32:
+		return "float32";
+	case DEPTH_FORMAT_UNORM16:
+		return "unorm16";
+	case DEPTH_FORMAT_UNORM24:
+		return "unorm24";
+	default:
+		return "unknown";
+	}
+}
+
+const char* Get_Parallel_Mode_Name(void)
+{
+	switch (ParallelMode)
+	{
+	case PARALLEL_NONE:
+		return "single thread";
+	case PARALLEL_TILES:
+		return "tiles";
+	case PARALLEL_INTERLEAVED:
+		return "interleaved";
+	default:
+		return "unknown";
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Functions
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Bytes of each value of the depth buffer
+static size_t Get_Depth_Size(void)
+{
+	return (DepthFormat == DEPTH_FORMAT_UNORM16) ? sizeof(uint16_t) : (DepthFormat == DEPTH_FORMAT_UNORM24) ? sizeof(uint32_t) : sizeof(float);
+}
+
 // Creating a SDL Window
-bool Initialize_Window(void)
+bool Initialize_Window(int Format)
 {
 	//If there're no errors while initializing SDL's input, graphics, and stuff
 	if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
@@ -157,7 +520,14 @@ bool Initialize_Window(void)
 	// Dynamically allocate a certain number of bytes in the heap for the Color Buffer (casting the allocation to uint32_t*)
 	// (the size that each pixel needs to store a color * window width * window height)
 	// sizeof is a language operator, not a function. It's provided by the compiler and it's implementation specific.
-	ColorBuffer = (color_t*)malloc(sizeof(color_t) * WindowWidth * WindowHeight);
+#if defined(TILED_FRAMEBUFFER)
+	BufferWidth = (WindowWidth + FRAMEBUFFER_TILE_SIZE - 1) & ~(FRAMEBUFFER_TILE_SIZE - 1);
+	BufferHeight = (WindowHeight + FRAMEBUFFER_TILE_SIZE - 1) & ~(FRAMEBUFFER_TILE_SIZE - 1);
+#else
+	BufferWidth = WindowWidth;
+	BufferHeight = WindowHeight;
+#endif
+	ColorBuffer = (color_t*)malloc(sizeof(color_t) * BufferWidth * BufferHeight);
 	if (ColorBuffer == NULL)
 	{
 		// If malloc returns a NULL pointer, the allocation wasn't successful (maybe the machine doesn't have enough free memory)
@@ -174,55 +544,287 @@ bool Initialize_Window(void)
 		Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, WindowWidth, WindowHeight
 	);
 
-	// Dynamically allocate a certain number of bytes in the heap for the Z/depth Buffer (casting the allocation to float*)
-	ZBuffer = (float*)malloc(sizeof(float) * WindowWidth * WindowHeight);
+	// Dynamically allocate a certain number of bytes in the heap for the Z/depth Buffer, with the size of its format
+	DepthFormat = Format;
+	ZBuffer = malloc(Get_Depth_Size() * BufferWidth * BufferHeight);
+
+	// One coarse depth per block, rounding up so the blocks cover the right and bottom borders of the screen too
+	DepthBlocksX = (WindowWidth + DEPTH_BLOCK_SIZE - 1) / DEPTH_BLOCK_SIZE;
+	DepthBlocksY = (WindowHeight + DEPTH_BLOCK_SIZE - 1) / DEPTH_BLOCK_SIZE;
+	ZBufferBlockMax = (float*)malloc(sizeof(float) * DepthBlocksX * DepthBlocksY);
+
+	VisibilityBuffer = (uint32_t*)malloc(sizeof(uint32_t) * BufferWidth * BufferHeight);
+
+	ScreenTarget.ColorBuffer = ColorBuffer;
+	ScreenTarget.ZBuffer = ZBuffer;
+	ScreenTarget.VisibilityBuffer = VisibilityBuffer;
+	ScreenTarget.TriangleId = 0;
+	ScreenTarget.Width = BufferWidth;
+	ScreenTarget.OriginX = 0;
+	ScreenTarget.OriginY = 0;
 
 	return true;
 }
 
+// Set Count 32bit values of a buffer, with non-temporal SIMD stores for everything after the first aligned address
+static void Fill_Buffer_Streaming(uint32_t* Buffer, uint32_t Value, int Count)
+{
+	int idx = 0;
+
+#if defined(CLEAR_SIMD_AVX2) || defined(CLEAR_SIMD_SSE2)
+	// Streaming stores need aligned addresses, so the first few values are regular stores
+	for (; idx < Count && ((uintptr_t)&Buffer[idx] % CLEAR_SIMD_ALIGNMENT) != 0; idx++)
+	{
+		Buffer[idx] = Value;
+	}
+
+#if defined(CLEAR_SIMD_AVX2)
+	__m256i Values = _mm256_set1_epi32((int)Value);
+	for (; idx + 8 <= Count; idx += 8)
+	{
+		_mm256_stream_si256((__m256i*)&Buffer[idx], Values);
+	}
+#else
+	__m128i Values = _mm_set1_epi32((int)Value);
+	for (; idx + 4 <= Count; idx += 4)
+	{
+		_mm_stream_si128((__m128i*)&Buffer[idx], Values);
+	}
+#endif
+
+	// Streaming stores are weakly ordered, make sure they're done before anyone (like the raster threads) reads the buffer
+	_mm_sfence();
+#endif
+
+	// What's left after the last whole register (or everything, without SIMD)
+	for (; idx < Count; idx++)
+	{
+		Buffer[idx] = Value;
+	}
+}
+
+// Copy Size bytes, with non-temporal SIMD stores for everything after the first aligned address of the destination
+// The caller makes sure the stores are done (_mm_sfence) once it's finished with all its copies
+static void Copy_Buffer_Streaming(void* Destination, const void* Source, size_t Size)
+{
+	uint8_t* Bytes = (uint8_t*)Destination;
+	const uint8_t* SourceBytes = (const uint8_t*)Source;
+	size_t idx = 0;
+
+#if defined(CLEAR_SIMD_AVX2) || defined(CLEAR_SIMD_SSE2)
+	for (; idx < Size && ((uintptr_t)&Bytes[idx] % CLEAR_SIMD_ALIGNMENT) != 0; idx++)
+	{
+		Bytes[idx] = SourceBytes[idx];
+	}
+
+#if defined(CLEAR_SIMD_AVX2)
+	for (; idx + 32 <= Size; idx += 32)
+	{
+		_mm256_stream_si256((__m256i*)&Bytes[idx], _mm256_loadu_si256((const __m256i*)&SourceBytes[idx]));
+	}
+#else
+	for (; idx + 16 <= Size; idx += 16)
+	{
+		_mm_stream_si128((__m128i*)&Bytes[idx], _mm_loadu_si128((const __m128i*)&SourceBytes[idx]));
+	}
+#endif
+#endif
+
+	if (idx < Size)
+	{
+		memcpy(&Bytes[idx], &SourceBytes[idx], Size - idx);
+	}
+}
+
 // Clear the Color Buffer (it's like animating in a white board: you erase the previous frame and draw the new one on top)
 void Clear_ColorBuffer(color_t ClearColor)
 {
-	//for (int Row = 0; Row < WindowHeight; Row++) // Rows
-	//{
-	//	for (int Col = 0; Col < WindowWidth; Col++) // Columns
-	//	{
-	//		ColorBuffer[( (WindowWidth * Row) + Col)] = ClearColor;
-	//	}
-	//}
+	Fill_Buffer_Streaming(ColorBuffer, ClearColor, BufferWidth * BufferHeight);
+}
 
-	//memset(ColorBuffer, 0, WindowWidth * WindowHeight * 4);
+// Clear the ZBuffer and its coarse depth blocks (restart all their values with one)
+// With depth generations, only the first frame of each round clears them: the depths left by the previous frames are all
+// farther than the ones of this frame, and so are the old farthest depths of the blocks (they're still safe limits)
+void Clear_ZBuffer(void)
+{
+	if (DepthGeneration > 0 && !bZBufferClearSkipped)
+	{
+		return;
+	}
+	bZBufferClearSkipped = false;
 
-	int WindowSize = WindowWidth * WindowHeight;
-	for (int idx = 0; idx < WindowSize; idx++)
+	// The buffer is filled with the farthest depth of its format: the bits of the float 1.0, or the max of the integer ones
+	int NumPixels = BufferWidth * BufferHeight;
+	switch (DepthFormat)
 	{
-		ColorBuffer[idx] = ClearColor;
+	case DEPTH_FORMAT_UNORM16:
+		// 2 depths per 32bit value, and the last one on its own when there's an odd number of pixels
+		Fill_Buffer_Streaming((uint32_t*)ZBuffer, (DEPTH_UNORM16_MAX << 16) | DEPTH_UNORM16_MAX, NumPixels / 2);
+		if (NumPixels % 2 != 0)
+		{
+			((uint16_t*)ZBuffer)[NumPixels - 1] = DEPTH_UNORM16_MAX;
+		}
+		break;
+	case DEPTH_FORMAT_UNORM24:
+		Fill_Buffer_Streaming((uint32_t*)ZBuffer, DEPTH_UNORM24_MAX, NumPixels);
+		break;
+	default:
+	{
+		float ClearDepth = 1.0f;
+		uint32_t ClearDepthBits;
+		memcpy(&ClearDepthBits, &ClearDepth, sizeof(ClearDepthBits));
+		Fill_Buffer_Streaming((uint32_t*)ZBuffer, ClearDepthBits, NumPixels);
+		break;
+	}
 	}
 
-	/*for (int idx = 0; idx < WindowSize; idx += 4)
+	int NumBlocks = DepthBlocksX * DepthBlocksY;
+	for (int idx = 0; idx < NumBlocks; idx++)
 	{
-		ColorBuffer[idx] = ClearColor;
-		ColorBuffer[idx + 1] = ClearColor;
-		ColorBuffer[idx + 2] = ClearColor;
-		ColorBuffer[idx + 3] = ClearColor;
-	}*/
+		ZBufferBlockMax[idx] = 1.0;
+	}
 }
 
-// Clear the ZBuffer (restart all its values with one)
-void Clear_ZBuffer(void)
+void Advance_Depth_Generation(void)
+{
+	// Turning them off goes back to the generation that clears the ZBuffer
+	// The integer formats have no room for the generations (they use their whole range between 1/W = 0 and 1/ZNear)
+	bool bUseGenerations = bDepthGenerations && (DepthFormat == DEPTH_FORMAT_FLOAT32);
+	DepthGeneration = bUseGenerations ? (DepthGeneration + 1) % DEPTH_GENERATIONS : 0;
+}
+
+// The depths left in the ZBuffer can be from any older generation now, even the current one
+void Skip_ZBuffer_Clear(void)
+{
+	bZBufferClearSkipped = true;
+}
+
+// The buffers of a tile are small enough to stay in the caches of its thread, so they're cleared with regular stores
+void Clear_Render_Target(const render_target_t* Target, int NumPixels, int X1, int Y1, color_t ClearColor)
 {
-	int WindowSize = WindowWidth * WindowHeight;
-	for (int idx = 0; idx < WindowSize; idx++)
+	for (int idx = 0; idx < NumPixels; idx++)
 	{
-		ZBuffer[idx] = 1.0;
+		Target->ColorBuffer[idx] = ClearColor;
 	}
+
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_UNORM16:
+		for (int idx = 0; idx < NumPixels; idx++)
+		{
+			((uint16_t*)Target->ZBuffer)[idx] = DEPTH_UNORM16_MAX;
+		}
+		break;
+	case DEPTH_FORMAT_UNORM24:
+		for (int idx = 0; idx < NumPixels; idx++)
+		{
+			((uint32_t*)Target->ZBuffer)[idx] = DEPTH_UNORM24_MAX;
+		}
+		break;
+	default:
+		for (int idx = 0; idx < NumPixels; idx++)
+		{
+			((float*)Target->ZBuffer)[idx] = 1.0f;
+		}
+		break;
+	}
+
+	// The tile doesn't share its blocks with any other, so only its thread ever touches their coarse depth
+	for (int BlockY = Target->OriginY / DEPTH_BLOCK_SIZE; BlockY <= Y1 / DEPTH_BLOCK_SIZE; BlockY++)
+	{
+		for (int BlockX = Target->OriginX / DEPTH_BLOCK_SIZE; BlockX <= X1 / DEPTH_BLOCK_SIZE; BlockX++)
+		{
+			ZBufferBlockMax[(BlockY * DepthBlocksX) + BlockX] = 1.0f;
+		}
+	}
+}
+
+void Resolve_Render_Target(const render_target_t* Target, int X1, int Y1, bool bWithDepth)
+{
+	size_t DepthSize = Get_Depth_Size();
+
+#if defined(TILED_FRAMEBUFFER)
+	// A row of framebuffer tiles is contiguous in both layouts, so each copy is a band of FRAMEBUFFER_TILE_SIZE rows
+	// (the last tile of the band can go into the padding of the buffers, it's the same cleared padding of the tile)
+	int RowsPerCopy = FRAMEBUFFER_TILE_SIZE;
+	int PixelsPerCopy = (((X1 - Target->OriginX) / FRAMEBUFFER_TILE_SIZE) + 1) * FRAMEBUFFER_TILE_SIZE * FRAMEBUFFER_TILE_SIZE;
+#else
+	int RowsPerCopy = 1;
+	int PixelsPerCopy = X1 - Target->OriginX + 1;
+#endif
+
+	for (int y = Target->OriginY; y <= Y1; y += RowsPerCopy)
+	{
+		int ScreenIndex = Pixel_Row_Offset(y, BufferWidth) + Pixel_Column_Offset(Target->OriginX);
+		int TileIndex = Pixel_Row_Offset(y - Target->OriginY, Target->Width);
+
+		Copy_Buffer_Streaming(&ColorBuffer[ScreenIndex], &Target->ColorBuffer[TileIndex], sizeof(color_t) * PixelsPerCopy);
+		if (bWithDepth)
+		{
+			Copy_Buffer_Streaming((uint8_t*)ZBuffer + (DepthSize * ScreenIndex), (const uint8_t*)Target->ZBuffer + (DepthSize * TileIndex), DepthSize * PixelsPerCopy);
+		}
+	}
+
+#if defined(CLEAR_SIMD_AVX2) || defined(CLEAR_SIMD_SSE2)
+	// The main thread presents the color buffer once all the tiles are done, the stores have to be visible by then
+	_mm_sfence();
+#endif
 }
 
+// Clear the visibility buffer (zero means no triangle covers the pixel)
+void Clear_Visibility_Buffer(void)
+{
+	memset(VisibilityBuffer, 0, sizeof(uint32_t) * BufferWidth * BufferHeight);
+}
+
+#if defined(TILED_FRAMEBUFFER)
+// Copy the tiled Color Buffer into the rows of the texture (Pitch bytes apart), one row of a tile at a time
+static void Detile_ColorBuffer(void* Pixels, int Pitch)
+{
+	for (int y = 0; y < WindowHeight; y++)
+	{
+		color_t* TextureRow = (color_t*)((uint8_t*)Pixels + ((size_t)Pitch * y));
+		const color_t* BufferRow = &ColorBuffer[Pixel_Row_Offset(y, BufferWidth)];
+
+		int x = 0;
+		for (; x + FRAMEBUFFER_TILE_SIZE <= WindowWidth; x += FRAMEBUFFER_TILE_SIZE)
+		{
+			const color_t* TileRow = &BufferRow[Pixel_Column_Offset(x)];
+#if defined(CLEAR_SIMD_AVX2)
+			_mm256_storeu_si256((__m256i*)&TextureRow[x], _mm256_loadu_si256((const __m256i*)TileRow));
+#elif defined(CLEAR_SIMD_SSE2)
+			_mm_storeu_si128((__m128i*)&TextureRow[x], _mm_loadu_si128((const __m128i*)TileRow));
+			_mm_storeu_si128((__m128i*)&TextureRow[x + 4], _mm_loadu_si128((const __m128i*)&TileRow[4]));
+#else
+			memcpy(&TextureRow[x], TileRow, sizeof(color_t) * FRAMEBUFFER_TILE_SIZE);
+#endif
+		}
+
+		// The last tile of the row can be cut by the right border of the window
+		for (; x < WindowWidth; x++)
+		{
+			TextureRow[x] = BufferRow[Pixel_Column_Offset(x)];
+		}
+	}
+}
+#endif
+
 // Copy all the Color Buffer's pixels in a texture and displays it
 void Render_ColorBuffer(void)
 {
+#if defined(TILED_FRAMEBUFFER)
+	// Detile straight into the memory of the streaming texture, instead of going through a row by row copy first
+	void* Pixels = NULL;
+	int Pitch = 0;
+	if (SDL_LockTexture(ColorBufferTexture, NULL, &Pixels, &Pitch) == 0)
+	{
+		Detile_ColorBuffer(Pixels, Pitch);
+		SDL_UnlockTexture(ColorBufferTexture);
+	}
+#else
 	// Texture pitch = size of each row (how many bytes for each row of the texture)
 	SDL_UpdateTexture(ColorBufferTexture, NULL, ColorBuffer, (int)(WindowWidth * sizeof(color_t)));
+#endif
 	SDL_RenderCopy(Renderer, ColorBufferTexture, NULL, NULL);
 
 	// Update the screen, presenting the backbuffer that contains the stuff you want to draw
@@ -236,8 +838,8 @@ void Draw_Pixel(int x, int y, color_t Color)
 		return;
 	}
 
-	// (Total rows in the screen * how many rows) + how many columns
-	ColorBuffer[(WindowWidth * y) + x] = Color;
+	// (Total rows in the screen * how many rows) + how many columns (or the tile of the pixel with TILED_FRAMEBUFFER)
+	ColorBuffer[Pixel_Row_Offset(y, BufferWidth) + Pixel_Column_Offset(x)] = Color;
 }
 
 void DrawLine_Bresenham(int x0, int y0, int x1, int y1, color_t LineColor)
@@ -357,7 +959,7 @@ void Draw_Grid(int CellSpacing, color_t LineColor)
 	{
 		for (int Col = 0; Col < WindowWidth; Col++) // Columns
 		{
-			ColorBuffer[((WindowWidth * Row) + Col)] = LineColor;
+			ColorBuffer[Pixel_Row_Offset(Row, BufferWidth) + Pixel_Column_Offset(Col)] = LineColor;
 		}
 	}
 
@@ -366,7 +968,7 @@ void Draw_Grid(int CellSpacing, color_t LineColor)
 	{
 		for (int Col = 0; Col < WindowWidth; Col += CellSpacing) // Columns
 		{
-			ColorBuffer[((WindowWidth * Row) + Col)] = LineColor;
+			ColorBuffer[Pixel_Row_Offset(Row, BufferWidth) + Pixel_Column_Offset(Col)] = LineColor;
 		}
 	}
 }
@@ -388,6 +990,8 @@ void Draw_Rectangle(int x, int y, int Width, int Height, color_t Color)
 void Destroy_Window(void)
 {
 	// Free the memory in the reverse order that it was allocated
+	free(VisibilityBuffer);
+	free(ZBufferBlockMax);
 	free(ZBuffer);
 	free(ColorBuffer);
 	SDL_DestroyTexture(ColorBufferTexture);
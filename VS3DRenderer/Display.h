@@ -10,50 +10,198 @@
 #define FPS 30 // Update loop Frames Per Second
 #define FRAME_TARGET_TIME (1000/FPS) // How many miliseconds each frame should take in order to complete 30FPS
 
+// Size of the square blocks of pixels of the coarse depth buffer (hierarchical Z), which keeps the farthest depth of each block
+#define DEPTH_BLOCK_SIZE 8
+
 // Declare a new typedef to hold unsigned 32bit color values
 typedef uint32_t color_t;
 
 enum ECull_Mode {
 	CULL_NONE,
-	CULL_BACKFACE
+	CULL_BACKFACE, // Camera ray against the face normal, before clipping
+	CULL_SCREEN_AREA // Sign of the area of the projected triangle, which also culls the ones without area
 };
 
+// What each render mode draws: X(Mode, Name, bFill, bTextured, bWireframe, bVertices)
+// The enum below, the Should_Render_* functions and the triangle renderers specialized for each mode are generated from it
+#define RENDER_MODE_LIST(X) \
+	X(RENDER_WIRE,               Wire,          false, false, true,  false) \
+	X(RENDER_WIRE_VERTEX,        Wire_Vertex,   false, false, true,  true ) \
+	X(RENDER_FILL_TRIANGLE,      Fill,          true,  false, false, false) \
+	X(RENDER_FILL_TRIANGLE_WIRE, Fill_Wire,     true,  false, true,  false) \
+	X(RENDER_TEXTURED,           Textured,      false, true,  false, false) \
+	X(RENDER_TEXTURED_WIRE,      Textured_Wire, false, true,  true,  false)
+
+#define RENDER_MODE_ENUM(Mode, Name, bFill, bTextured, bWireframe, bVertices) Mode,
+
 enum ERender_Mode {
-	RENDER_WIRE,
-	RENDER_WIRE_VERTEX,
-	RENDER_FILL_TRIANGLE,
-	RENDER_FILL_TRIANGLE_WIRE,
-	RENDER_TEXTURED,
-	RENDER_TEXTURED_WIRE
+	RENDER_MODE_LIST(RENDER_MODE_ENUM)
+	NUM_RENDER_MODES
+};
+
+enum ERaster_Mode {
+	RASTER_SCANLINE, // Flat-top/flat-bottom scanlines with barycentric weights computed per pixel
+	RASTER_EDGE_FUNCTION, // Half-space edge functions stepped incrementally across the triangle's bounding box
+	RASTER_EDGE_FUNCTION_SIMD // Same edge functions, but shading 4 (SSE2) or 8 (AVX2) pixels per iteration
+};
+
+enum EParallel_Mode {
+	PARALLEL_NONE, // The main thread rasterizes every triangle
+	PARALLEL_TILES, // Triangles are binned into screen tiles, and a pool of threads rasterizes the tiles (edge functions only)
+	PARALLEL_INTERLEAVED // Each thread rasterizes every Nth band of scanlines of all the triangles (edge functions only)
 };
 
+// Perspective span subdivision: the textures are perspective correct (one division by the interpolated 1/W) only every
+// this many pixels of each span, and U/V are interpolated linearly in between. Multiples of the SIMD width (8 with AVX2)
+#define PERSPECTIVE_SPAN_EXACT 0 // Divide for every pixel (default)
+#define PERSPECTIVE_SPAN_SHORT 8
+#define PERSPECTIVE_SPAN_LONG 16
+
+// Depth generations: instead of clearing the depth buffer every frame, each frame stores its depths (bias - 1/W) with a bias
+// lower than the previous frame, so whatever is left from the older frames is always farther than anything new. The spacing
+// between the biases has to be bigger than any 1/W, so Set_Near_Plane makes it the smallest power of two above 1/ZNear, and
+// the buffer is only really cleared once every DEPTH_GENERATIONS frames, since every generation loses a bit of depth
+// precision (the bias gets further from zero)
+#define DEPTH_GENERATIONS 4
+
+// Framebuffer layout: compiling with TILED_FRAMEBUFFER defined stores the color, depth and visibility buffers in tiles of
+// FRAMEBUFFER_TILE_SIZE x FRAMEBUFFER_TILE_SIZE pixels (each tile contiguous in memory, row by row inside it) instead of
+// whole rows, so a tall and thin triangle doesn't touch a new cache line on every row. The buffers are padded to whole tiles
+// and Render_ColorBuffer detiles the colors into the SDL texture. The tiles are the same as the raster blocks
+#if defined(TILED_FRAMEBUFFER)
+#define FRAMEBUFFER_TILE_SIZE 8
+#define FRAMEBUFFER_TILE_SHIFT 3 // log2(FRAMEBUFFER_TILE_SIZE)
+#endif
+
+// Formats of the depth buffer, chosen when the window is created (they can't change afterwards, the buffer is allocated for it)
+enum EDepth_Format {
+	DEPTH_FORMAT_FLOAT32, // bias - 1/W as a float (default)
+	DEPTH_FORMAT_UNORM16, // 1/W quantized to 16 bits, half the memory traffic of the float buffer
+	DEPTH_FORMAT_UNORM24, // 1/W quantized to 24 bits, stored in 32bit words
+	NUM_DEPTH_FORMATS
+};
+
+// The integer formats store 1/W scaled from [0, 1/ZNear] to [0, max] and flipped (max - scaled 1/W), so 1/W = 0 (infinitely
+// far) is max (the clear value), closer pixels have smaller values and the depth test is still "less than"
+// 1/ZNear is the biggest 1/W after clipping (see Set_Near_Plane), anything closer is clamped to 0
+#define DEPTH_UNORM16_MAX 0xFFFF
+#define DEPTH_UNORM24_MAX 0xFFFFFF
+
+// A depth value in the format of the depth buffer: the float, or the quantized integer
+typedef union
+{
+	float Float;
+	uint32_t Unorm;
+}depth_value_t;
+
+// Where the rasterizers write their pixels: the screen buffers, or the small buffers of a single tile (see Tiles.c)
+// Pixel (x,y) of the screen is at Pixel_Row_Offset(y - OriginY, Width) + Pixel_Column_Offset(x - OriginX) of its buffers
+typedef struct
+{
+	color_t* ColorBuffer;
+	void* ZBuffer; // In the format of Get_Depth_Format
+	uint32_t* VisibilityBuffer; // Only the screen has one
+	uint32_t TriangleId; // What the visibility pass writes into VisibilityBuffer (see Render_Visibility_Buffer)
+	int Width; // Pixels of each row of the buffers (padded to whole tiles with TILED_FRAMEBUFFER)
+	int OriginX; // Screen pixel at the start of the buffers, a multiple of FRAMEBUFFER_TILE_SIZE with TILED_FRAMEBUFFER
+	int OriginY;
+}render_target_t;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Getters/Setters
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int Get_Window_Width(void);
 int Get_Window_Height(void);
+// Size of the color, depth and visibility buffers in pixels (the window size, padded to whole tiles with TILED_FRAMEBUFFER)
+int Get_Buffer_Width(void);
+int Get_Buffer_Height(void);
 float Get_ZBuffer_At(int x, int y);
 void Update_ZBuffer_At(int x, int y, float value);
+color_t* Get_ColorBuffer(void);
+// The depth buffer: floats, uint16_t or uint32_t values depending on Get_Depth_Format
+void* Get_ZBuffer(void);
+float* Get_ZBuffer_Block_Max(void);
+uint32_t* Get_Visibility_Buffer(void);
+// The color, depth and visibility buffers of the whole screen
+const render_target_t* Get_Screen_Target(void);
+int Get_Depth_Blocks_Per_Row(void);
 void Set_Render_Mode(int Mode);
 void Set_Cull_Mode(int Mode);
+void Set_Raster_Mode(int Mode);
+void Set_Parallel_Mode(int Mode);
+void Set_Hierarchical_Z(bool bEnable);
+void Set_Depth_Prepass(bool bEnable);
+void Set_Visibility_Buffer(bool bEnable);
+void Set_Span_Buffer(bool bEnable);
+void Set_Guard_Band(bool bEnable);
+void Set_Clip_Space_Clipping(bool bEnable);
+void Set_Front_To_Back(bool bEnable);
+void Set_Specialized_Renderers(bool bEnable);
+void Set_Perspective_Span_Length(int Length);
+void Set_Clear_Elision(bool bEnable);
+void Set_Depth_Generations(bool bEnable);
+void Set_Tile_Buffers(bool bEnable);
+// Distance from the camera to the near plane of the projection, which sets the range of the integer depth formats and the
+// spacing of the depth generations
+void Set_Near_Plane(float ZNear);
 
 bool Is_Cull_Backface(void);
+bool Is_Cull_Screen_Area(void);
+int Get_Render_Mode(void);
 bool Should_Render_Fill_Triangles(void);
 bool Should_Render_Wireframe_Triangles(void);
 bool Should_Render_Textured_Triangles(void);
 bool Should_Render_Triangle_Vertices(void);
+bool Is_Raster_Edge_Function(void);
+bool Is_Raster_SIMD(void);
+const char* Get_Raster_Mode_Name(void);
+bool Is_Parallel_Tiles(void);
+bool Is_Parallel_Interleaved(void);
+const char* Get_Parallel_Mode_Name(void);
+bool Is_Hierarchical_Z(void);
+bool Is_Depth_Prepass(void);
+bool Is_Visibility_Buffer(void);
+bool Is_Span_Buffer(void);
+bool Is_Guard_Band(void);
+bool Is_Clip_Space_Clipping(void);
+bool Is_Front_To_Back(void);
+bool Is_Specialized_Renderers(void);
+int Get_Perspective_Span_Length(void);
+bool Is_Clear_Elision(void);
+bool Is_Depth_Generations(void);
+bool Is_Tile_Buffers(void);
+// What the depths of this frame are subtracted from (1 without depth generations): depth = bias - 1/W
+float Get_Depth_Bias(void);
+// What 1/W is multiplied by to quantize it into the integer depth formats: their max value / the biggest 1/W (1/ZNear)
+float Get_Depth_Scale(void);
+int Get_Depth_Format(void);
+const char* Get_Depth_Format_Name(void);
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Functions
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// Creating a SDL Window
-bool Initialize_Window(void);
+// Creating a SDL Window, and the buffers (the depth buffer with one of the EDepth_Format formats)
+bool Initialize_Window(int DepthFormat);
 // Clear the Color Buffer (it's like animating in a white board: you erase the previous frame and draw the new one on top)
 void Clear_ColorBuffer(color_t ClearColor);
-// Clear the ZBuffer (restart all its values with one)
+// Clear the ZBuffer and its coarse depth blocks (restart all their values with one)
+// With depth generations, only the first frame of each round clears them
 void Clear_ZBuffer(void);
+// Move the depth bias to the next generation, once the frame is done with the ZBuffer
+void Advance_Depth_Generation(void);
+// The frame keeps its depths somewhere else (the tile buffers), so the ZBuffer isn't cleared, and the next frame that
+// uses it clears it no matter its depth generation
+void Skip_ZBuffer_Clear(void);
+// Fill the first NumPixels pixels of the buffers of a tile with ClearColor and the farthest depth, and restart the
+// coarse depth of the blocks in (OriginX,OriginY)-(X1,Y1)
+void Clear_Render_Target(const render_target_t* Target, int NumPixels, int X1, int Y1, color_t ClearColor);
+// Copy the pixels (OriginX,OriginY)-(X1,Y1) of a tile into the screen buffers with non-temporal stores: the colors,
+// and the depths when bWithDepth
+void Resolve_Render_Target(const render_target_t* Target, int X1, int Y1, bool bWithDepth);
+// Clear the visibility buffer (zero means no triangle covers the pixel)
+void Clear_Visibility_Buffer(void);
 // Copy all the Color Buffer's pixels in a texture and displays it
 void Render_ColorBuffer(void);
 void Draw_Pixel(int x, int y, color_t Color);
@@ -65,5 +213,115 @@ void Draw_Rectangle(int x, int y, int Width, int Height, color_t Color);
 // Release anything that was allocated
 void Destroy_Window(void);
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pixel addressing
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The index of pixel (x,y) in the buffers is Pixel_Row_Offset(y) + Pixel_Column_Offset(x) in both layouts, so the rasterizers
+// compute the row part once per row. BufferWidth is Get_Buffer_Width()
+
+SDL_FORCE_INLINE int Pixel_Row_Offset(int y, int BufferWidth)
+{
+#if defined(TILED_FRAMEBUFFER)
+	// Every row of tiles above it, and then the rows above it inside its tiles
+	return ((y >> FRAMEBUFFER_TILE_SHIFT) * BufferWidth * FRAMEBUFFER_TILE_SIZE) + ((y & (FRAMEBUFFER_TILE_SIZE - 1)) * FRAMEBUFFER_TILE_SIZE);
+#else
+	return y * BufferWidth;
+#endif
+}
+
+SDL_FORCE_INLINE int Pixel_Column_Offset(int x)
+{
+#if defined(TILED_FRAMEBUFFER)
+	// Every tile to its left, and then its column inside its tile
+	return ((x >> FRAMEBUFFER_TILE_SHIFT) * FRAMEBUFFER_TILE_SIZE * FRAMEBUFFER_TILE_SIZE) + (x & (FRAMEBUFFER_TILE_SIZE - 1));
+#else
+	return x;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Depth values
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The rasterizers call these with a constant DepthFormat, so each of their pixel loops only keeps the code of one format
+
+// Call one of the pixel loops with the format of the depth buffer as a constant (its last parameter)
+#define CALL_WITH_DEPTH_FORMAT(Loop, ...) \
+	switch (Get_Depth_Format()) \
+	{ \
+	case DEPTH_FORMAT_UNORM16: \
+		return Loop(__VA_ARGS__, DEPTH_FORMAT_UNORM16); \
+	case DEPTH_FORMAT_UNORM24: \
+		return Loop(__VA_ARGS__, DEPTH_FORMAT_UNORM24); \
+	default: \
+		return Loop(__VA_ARGS__, DEPTH_FORMAT_FLOAT32); \
+	}
+
+// Quantize 1/W to an integer depth between 0 (at the near plane or closer) and MaxValue (1/W = 0, infinitely far)
+SDL_FORCE_INLINE uint32_t Quantize_Depth(float ReciprocalW, float DepthScale, uint32_t MaxValue)
+{
+	float Scaled = (ReciprocalW * DepthScale) + 0.5f;
+	Scaled = SDL_min(SDL_max(Scaled, 0.0f), (float)MaxValue);
+	return MaxValue - (uint32_t)Scaled;
+}
+
+// The depth of a pixel with that 1/W, in the format of the depth buffer
+SDL_FORCE_INLINE depth_value_t Make_Depth(float ReciprocalW, float DepthBias, float DepthScale, int DepthFormat)
+{
+	depth_value_t Depth;
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_UNORM16:
+		Depth.Unorm = Quantize_Depth(ReciprocalW, DepthScale, DEPTH_UNORM16_MAX);
+		break;
+	case DEPTH_FORMAT_UNORM24:
+		Depth.Unorm = Quantize_Depth(ReciprocalW, DepthScale, DEPTH_UNORM24_MAX);
+		break;
+	default:
+		// Adjust the reciprocal W so the pixels that are closer to the camera have smaller values
+		Depth.Float = DepthBias - ReciprocalW;
+		break;
+	}
+	return Depth;
+}
+
+// Depth test against the pixel Index of the depth buffer: closer than it, or exactly the same depth when bEqualDepth
+SDL_FORCE_INLINE bool Test_Depth(const void* ZBuffer, int Index, depth_value_t Depth, int DepthFormat, bool bEqualDepth)
+{
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_UNORM16:
+	{
+		uint32_t OldDepth = ((const uint16_t*)ZBuffer)[Index];
+		return bEqualDepth ? (Depth.Unorm == OldDepth) : (Depth.Unorm < OldDepth);
+	}
+	case DEPTH_FORMAT_UNORM24:
+	{
+		uint32_t OldDepth = ((const uint32_t*)ZBuffer)[Index];
+		return bEqualDepth ? (Depth.Unorm == OldDepth) : (Depth.Unorm < OldDepth);
+	}
+	default:
+	{
+		float OldDepth = ((const float*)ZBuffer)[Index];
+		return bEqualDepth ? (Depth.Float == OldDepth) : (Depth.Float < OldDepth);
+	}
+	}
+}
+
+SDL_FORCE_INLINE void Store_Depth(void* ZBuffer, int Index, depth_value_t Depth, int DepthFormat)
+{
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_UNORM16:
+		((uint16_t*)ZBuffer)[Index] = (uint16_t)Depth.Unorm;
+		break;
+	case DEPTH_FORMAT_UNORM24:
+		((uint32_t*)ZBuffer)[Index] = Depth.Unorm;
+		break;
+	default:
+		((float*)ZBuffer)[Index] = Depth.Float;
+		break;
+	}
+}
+
 #endif // !DISPLAY_H
 
@@ -0,0 +1,78 @@
+#include "Interleaved.h"
+#include "RasterThreads.h"
+#include "Stats.h"
+#include "TriangleSetups.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Current job, shared (read only) by all the threads
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int JobNumSetups = 0;
+static bool bJobDepthPrepass = false;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Rasterize the rows of the triangles that belong to the bands of one thread
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int Rasterize_Thread_Bands_Pass(int ThreadIndex, int NumThreads, int Pass)
+{
+	int ShadedPixels = 0;
+
+	for (int idx = 0; idx < JobNumSetups; idx++)
+	{
+		const triangle_setup_t* Setup = Get_Triangle_Setup(idx);
+		if (Is_Triangle_Setup_Empty(Setup))
+		{
+			continue;
+		}
+
+		// First band of this thread at or after the first row of the triangle (the bounding box is already clamped
+		// to the screen), skipping the triangles none of whose rows belongs to this thread, the usual case for small ones
+		int FirstBand = Setup->MinY / RASTER_BLOCK_SIZE;
+		int LastBand = Setup->MaxY / RASTER_BLOCK_SIZE;
+		int Band = FirstBand + ((ThreadIndex - (FirstBand % NumThreads) + NumThreads) % NumThreads);
+
+		// Rasterize_Triangle_Rect clips each band to the bounding box
+		for (; Band <= LastBand; Band += NumThreads)
+		{
+			int Y0 = Band * RASTER_BLOCK_SIZE;
+			ShadedPixels += Rasterize_Triangle_Rect(Setup, Get_Screen_Target(), Pass, Setup->MinX, Y0, Setup->MaxX, Y0 + RASTER_BLOCK_SIZE - 1);
+		}
+	}
+
+	return ShadedPixels;
+}
+
+static void Rasterize_Thread_Bands(int ThreadIndex, int NumThreads)
+{
+	int ShadedPixels;
+	if (bJobDepthPrepass)
+	{
+		// The bands belong to this thread only, so there's no need to wait for the other threads between both passes
+		ShadedPixels = Rasterize_Thread_Bands_Pass(ThreadIndex, NumThreads, RASTER_PASS_DEPTH_ONLY);
+		ShadedPixels += Rasterize_Thread_Bands_Pass(ThreadIndex, NumThreads, RASTER_PASS_EQUAL_DEPTH);
+	}
+	else
+	{
+		ShadedPixels = Rasterize_Thread_Bands_Pass(ThreadIndex, NumThreads, RASTER_PASS_COLOR);
+	}
+
+	Add_Shaded_Pixels(ShadedPixels);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Rasterize_Interleaved(bool bIsTextured)
+{
+	JobNumSetups = Get_Num_Triangle_Setups();
+	if (JobNumSetups == 0)
+	{
+		return;
+	}
+
+	bJobDepthPrepass = Is_Depth_Prepass() && bIsTextured;
+
+	Run_Raster_Job(Rasterize_Thread_Bands);
+}
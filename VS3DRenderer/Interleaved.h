@@ -0,0 +1,38 @@
+#pragma once
+
+#ifndef INTERLEAVED_H
+#define INTERLEAVED_H
+
+#include <stdbool.h>
+#include "Triangle.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Multi-threaded rasterization with interleaved bands of scanlines
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	The screen rows are split in bands of RASTER_BLOCK_SIZE scanlines, and with N threads, thread K owns the bands
+	K, K + N, K + 2N... Every thread walks the whole list of setup records, and rasterizes only the rows of the
+	triangles that belong to its bands:
+
+	----------------  band 0 -> thread 0
+	      /\          band 1 -> thread 1
+	    /    \        band 2 -> thread 0
+	  /________\      band 3 -> thread 1
+	----------------
+
+	Unlike the tiles, there's no binning memory and no binning stage before the threads can start, at the cost of
+	every thread reading every record. That pays off with few big triangles (like a skydome), while the tiles are
+	better with lots of small ones.
+	Bands are whole blocks high, so the block classification still works inside each band
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Rasterize the setup records of the filled or textured triangles (see TriangleSetups.h) using every thread,
+// and wait until they're done
+void Rasterize_Interleaved(bool bIsTextured);
+
+#endif // !INTERLEAVED_H
@@ -13,6 +13,14 @@
 #include "Texture.h"
 #include "Camera.h"
 #include "Clipping.h"
+#include "Stats.h"
+#include "RasterThreads.h"
+#include "Tiles.h"
+#include "Interleaved.h"
+#include "DepthSort.h"
+#include "Visibility.h"
+#include "SpanBuffer.h"
+#include "TriangleSetups.h"
 
 // Left-handed coordinate system here (inside the monitor +Z outside -Z, o the right +X left -X, up +Y down -Y )
 
@@ -45,6 +53,13 @@ mat4_t PerspectiveProjectionMat;
 int WindowWidth;
 int WindowHeight;
 
+// Color of the pixels that no triangle covers
+#define CLEAR_COLOR 0x00000000
+
+// Closest and farthest distances of a sky dome to the camera that keep the whole dome between the near and far planes
+static float SkyDomeMinDistance = 0.0f;
+static float SkyDomeMaxDistance = 0.0f;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Setup function to initialize variables and game objects
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +69,8 @@ void Setup(void)
 	// Initialize the render mode and the triangle culling method
 	Set_Render_Mode(RENDER_TEXTURED);
 	Set_Cull_Mode(CULL_BACKFACE);
+	Set_Raster_Mode(RASTER_EDGE_FUNCTION_SIMD);
+	Set_Parallel_Mode(PARALLEL_TILES);
 
 	WindowWidth = Get_Window_Width();
 	WindowHeight = Get_Window_Height();
@@ -79,10 +96,19 @@ void Setup(void)
 	float FOVx = atan(tan(FOVy / 2.0) * AspectRatioX) * 2.0;
 	float ZNear = 0.1;
 	float ZFar = 100.0;
+	Set_Near_Plane(ZNear);
 	PerspectiveProjectionMat = Mat4_Make_PerspectiveProjection(FOVy, AspectRatioY, ZNear, ZFar);
 
+	// The rays of the corner pixels are the longest ones, so they cross the near plane the farthest from the camera
+	float CornerRayLength = sqrtf(1.0f + (tanf(FOVx / 2.0f) * tanf(FOVx / 2.0f)) + (tanf(FOVy / 2.0f) * tanf(FOVy / 2.0f)));
+	SkyDomeMinDistance = ZNear * CornerRayLength;
+	SkyDomeMaxDistance = ZFar;
+
 	// Initialize the View Frustrum planes  with a point and normal vector
 	Initialize_Frustrum_Planes(FOVx, FOVy, ZNear, ZFar);
+	Initialize_Guard_Band_Planes(FOVx, FOVy, WindowWidth, WindowHeight);
+	// The clip space planes don't depend on the FOV, only the guard band depends on the screen size
+	Initialize_Clip_Space_Planes(WindowWidth, WindowHeight);
 
 
 	/*
@@ -114,6 +140,8 @@ void Setup(void)
 	// Loads an OBJ model file (mesh) and a PNG file (texture) to save their data in the mesh data structure
 	// [ Rad = (Deg*PI)/180 = (90*PI)/180 = PI/2 ]
 	Load_Mesh("Assets/galaxy.obj", "Assets/galaxy4.png", Vec3_New(2, 2, 2), Vec3_New(0, 0, 8), Vec3_New(0, 0, 0));
+	// The galaxy surrounds the whole scene, so the color buffer doesn't need to be cleared while the camera is inside it
+	Set_Mesh_Sky_Dome(0);
 	//Load_Mesh("Assets/monkey.obj", "Assets/Monkey.png", Vec3_New(1, 1, 1), Vec3_New(-3, 0, 8), Vec3_New(0, 0, 0));
 	Load_Mesh("Assets/astronaut.obj", "Assets/astronaut2.png", Vec3_New(1, 1, 1), Vec3_New(0, 0, 8), Vec3_New((45 * M_PI) / 180, 0, 0));
 }
@@ -196,6 +224,157 @@ void Process_Input(void)
 				Set_Cull_Mode(CULL_NONE);
 				break;
 			}
+			//If a keyboard key was pressed, and it was the U key
+			if (Event.key.keysym.sym == SDLK_u)
+			{
+				Set_Cull_Mode(CULL_SCREEN_AREA);
+				break;
+			}
+			//If a keyboard key was pressed, and it was the F1 key
+			// Rasterize the triangles with the flat-top/flat-bottom scanline method
+			if (Event.key.keysym.sym == SDLK_F1)
+			{
+				Set_Raster_Mode(RASTER_SCANLINE);
+				break;
+			}
+			//If a keyboard key was pressed, and it was the F2 key
+			// Rasterize the triangles with incrementally stepped edge functions
+			if (Event.key.keysym.sym == SDLK_F2)
+			{
+				Set_Raster_Mode(RASTER_EDGE_FUNCTION);
+				break;
+			}
+			//If a keyboard key was pressed, and it was the F3 key
+			// Rasterize the triangles with edge functions, several pixels at a time with SIMD instructions
+			if (Event.key.keysym.sym == SDLK_F3)
+			{
+				Set_Raster_Mode(RASTER_EDGE_FUNCTION_SIMD);
+				break;
+			}
+			//If a keyboard key was pressed, and it was the F5 key
+			// Rasterize all the triangles in the main thread
+			if (Event.key.keysym.sym == SDLK_F5)
+			{
+				Set_Parallel_Mode(PARALLEL_NONE);
+				break;
+			}
+			//If a keyboard key was pressed, and it was the F6 key
+			// Bin the triangles into screen tiles, and rasterize the tiles with all the threads (edge functions only)
+			if (Event.key.keysym.sym == SDLK_F6)
+			{
+				Set_Parallel_Mode(PARALLEL_TILES);
+				break;
+			}
+			//If a keyboard key was pressed, and it was the F7 key
+			// Every thread rasterizes its own bands of scanlines of all the triangles (edge functions only)
+			if (Event.key.keysym.sym == SDLK_F7)
+			{
+				Set_Parallel_Mode(PARALLEL_INTERLEAVED);
+				break;
+			}
+			//If a keyboard key was pressed, and it was the H key
+			// Enable or disable the hierarchical Z (skipping triangles and blocks hidden behind what's already drawn)
+			if (Event.key.keysym.sym == SDLK_h)
+			{
+				Set_Hierarchical_Z(!Is_Hierarchical_Z());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the Z key
+			// Enable or disable the depth pre-pass (textured triangles are only shaded where they end up visible)
+			if (Event.key.keysym.sym == SDLK_z)
+			{
+				Set_Depth_Prepass(!Is_Depth_Prepass());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the V key
+			// Rasterize only the triangle IDs, and texture each visible pixel once afterwards (edge functions only)
+			if (Event.key.keysym.sym == SDLK_v)
+			{
+				Set_Visibility_Buffer(!Is_Visibility_Buffer());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the B key
+			// Solve the visibility with sorted spans per scanline, writing each pixel once without depth tests
+			if (Event.key.keysym.sym == SDLK_b)
+			{
+				Set_Span_Buffer(!Is_Span_Buffer());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the G key
+			// Clip against the guard band instead of the screen borders (the rasterizer skips the pixels outside the screen)
+			if (Event.key.keysym.sym == SDLK_g)
+			{
+				Set_Guard_Band(!Is_Guard_Band());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the C key
+			// Clip in homogeneous clip space after a single Model-View-Projection transform, or in camera space
+			if (Event.key.keysym.sym == SDLK_c)
+			{
+				Set_Clip_Space_Clipping(!Is_Clip_Space_Clipping());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the R key
+			// Render the triangles with the renderer specialized for the current modes, or with the generic one
+			if (Event.key.keysym.sym == SDLK_r)
+			{
+				Set_Specialized_Renderers(!Is_Specialized_Renderers());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the X key
+			// Cycle the perspective correction of the textures: every pixel, every 8 pixels, every 16 pixels
+			if (Event.key.keysym.sym == SDLK_x)
+			{
+				int SpanLength = Get_Perspective_Span_Length();
+				if (SpanLength == PERSPECTIVE_SPAN_EXACT)
+				{
+					Set_Perspective_Span_Length(PERSPECTIVE_SPAN_SHORT);
+				}
+				else if (SpanLength == PERSPECTIVE_SPAN_SHORT)
+				{
+					Set_Perspective_Span_Length(PERSPECTIVE_SPAN_LONG);
+				}
+				else
+				{
+					Set_Perspective_Span_Length(PERSPECTIVE_SPAN_EXACT);
+				}
+				break;
+			}
+			//If a keyboard key was pressed, and it was the L key
+			// Skip (or stop skipping) the color clear while a sky dome covers the whole screen
+			if (Event.key.keysym.sym == SDLK_l)
+			{
+				Set_Clear_Elision(!Is_Clear_Elision());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the N key
+			// Use (or stop using) depth generations, to clear the depth buffer only once every few frames
+			if (Event.key.keysym.sym == SDLK_n)
+			{
+				Set_Depth_Generations(!Is_Depth_Generations());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the T key
+			// Rasterize (or stop rasterizing) each screen tile into small buffers of its thread, copied to the screen once done
+			if (Event.key.keysym.sym == SDLK_t)
+			{
+				Set_Tile_Buffers(!Is_Tile_Buffers());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the F key
+			// Sort (or stop sorting) the triangles from front to back before rasterizing them
+			if (Event.key.keysym.sym == SDLK_f)
+			{
+				Set_Front_To_Back(!Is_Front_To_Back());
+				break;
+			}
+			//If a keyboard key was pressed, and it was the P key
+			// Print (or stop printing) the frame statistics to the console
+			if (Event.key.keysym.sym == SDLK_p)
+			{
+				Set_Show_Stats(!Is_Show_Stats());
+				break;
+			}
 			// If a keyboard key was pressed, and it was the W key
 			// Move forward (where the camera is currently looking)
 			if (Event.key.keysym.sym == SDLK_w)
@@ -284,6 +463,52 @@ void Process_Input(void)
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Small-primitive culling of a projected triangle
+///////////////////////////////////////////////////////////////////////////////
+// Only when the edge function rasterizer draws the faces alone: a triangle
+// that covers no pixel center still shows up in a wireframe, and the
+// scanline rasterizer doesn't sample at the pixel centers
+///////////////////////////////////////////////////////////////////////////////
+
+bool Can_Cull_Small_Triangles(void)
+{
+	return Is_Raster_Edge_Function() && !Should_Render_Wireframe_Triangles() && !Should_Render_Triangle_Vertices();
+}
+
+// Whether the raster path of this frame draws the filled/textured triangles from their setup records, instead of
+// setting them up while drawing them. The generic renderers set up their own triangles, like everything else they check
+bool Uses_Triangle_Setups(void)
+{
+	if (!Should_Render_Fill_Triangles() && !Should_Render_Textured_Triangles())
+	{
+		return false;
+	}
+	if (Is_Span_Buffer())
+	{
+		return true;
+	}
+	if (!Is_Raster_Edge_Function())
+	{
+		return false;
+	}
+	return Is_Visibility_Buffer() || Is_Parallel_Tiles() || Is_Parallel_Interleaved() || (Is_Depth_Prepass() && Should_Render_Textured_Triangles()) || Is_Specialized_Renderers();
+}
+
+// Classify (and count) the triangle, false if it can't cover any pixel
+bool Is_Projected_Triangle_Visible(const Triangle_t* ProjectedTriangle)
+{
+	int SizeClass = Classify_Triangle_Size(ProjectedTriangle->vertex[0], ProjectedTriangle->vertex[1], ProjectedTriangle->vertex[2]);
+	Add_Triangle_Size_Class(SizeClass);
+	return (SizeClass == TRIANGLE_SIZE_SMALL || SizeClass == TRIANGLE_SIZE_REGULAR);
+}
+
+// False for the projected triangles facing away from the camera, or without any area
+bool Is_Projected_Triangle_Front_Facing(const Triangle_t* ProjectedTriangle)
+{
+	return (Get_Triangle_Screen_Area(ProjectedTriangle->vertex[0], ProjectedTriangle->vertex[1], ProjectedTriangle->vertex[2]) > 0.0f);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Process the graphics pipeline stages for all the mesh triangles
 ///////////////////////////////////////////////////////////////////////////////
@@ -331,6 +556,15 @@ void Process_Graphics_Pipeline_Stages(mesh_t* CurrentMesh)
 	// Multiply the View Matrix by the world matrix to transform the scene to camera space
 	WorldMatrix = Mat4_Multiply_Mat4(ViewMatrix, WorldMatrix);
 
+	// Fuse the projection too, so the clip space path transforms each vertex with a single matrix
+	bool bClipSpace = Is_Clip_Space_Clipping();
+	mat4_t ModelViewProjectionMatrix = Mat4_Multiply_Mat4(PerspectiveProjectionMat, WorldMatrix);
+	clip_polygon_t ClipPolygon; // Reused by every triangle
+	bool bCullSmallTriangles = Can_Cull_Small_Triangles();
+	bool bCullScreenArea = Is_Cull_Screen_Area();
+	// Only the camera space backface culling and the flat shading of the filled triangles need the face normal
+	bool bNeedsFaceNormal = Is_Cull_Backface() || Should_Render_Fill_Triangles();
+
 	int NumBerOfFaces = Array_Length(CurrentMesh->Faces);
 
 	// Loop all triangle faces and for each one we render each vertex
@@ -344,12 +578,21 @@ void Process_Graphics_Pipeline_Stages(mesh_t* CurrentMesh)
 		FaceVertices[2] = CurrentMesh->Vertices[CurrentFace.c];
 
 		vec4_t TransformedVertices[3];
+		vec4_t ClipSpaceVertices[3];
 
 		// Loop all 3 vertices of the current face and apply transformations
 		for (int ind = 0; ind < 3; ind++)
 		{
 			vec4_t TransformedVertex = Vec3_To_Vec4(FaceVertices[ind]);
 
+			if (bClipSpace)
+			{
+				// Straight to clip space. The culling and the lighting get the camera space position back from it
+				ClipSpaceVertices[ind] = Mat4_Multiply_Vec4(ModelViewProjectionMatrix, TransformedVertex);
+				TransformedVertices[ind] = Mat4_Clip_To_Camera_Space(PerspectiveProjectionMat, ClipSpaceVertices[ind]);
+				continue;
+			}
+
 			// Multiply the World Matrix by our original vertices to scale, rotate and translate them (in that order!)
 			TransformedVertex = Mat4_Multiply_Vec4(WorldMatrix, TransformedVertex);
 
@@ -357,7 +600,11 @@ void Process_Graphics_Pipeline_Stages(mesh_t* CurrentMesh)
 		}
 
 		// Calculate the triangle face normal
-		vec3_t FaceNormal = Get_Triangle_Normal(TransformedVertices);
+		vec3_t FaceNormal = { 0,0,0 };
+		if (bNeedsFaceNormal)
+		{
+			FaceNormal = Get_Triangle_Normal(TransformedVertices);
+		}
 
 		///////////////  BACK FACE CULLING  ///////////////
 
@@ -380,20 +627,107 @@ void Process_Graphics_Pipeline_Stages(mesh_t* CurrentMesh)
 
 		///////////////  END BACK FACE CULLING  ///////////////
 
+		/* SIMPLE FLAT (PER TRIANGLE FACE) SHADING */
+
+		// The textured and wireframe modes don't use the face color
+		color_t FaceColor = CurrentFace.color;
+		if (Should_Render_Fill_Triangles())
+		{
+			// Calculate the shade intensity based on how aligned is the normal of a face with the inverse of the light ray
+			//Vec3_Normalize(&SunLight.LightDirection);
+			float LightIntensityFactor = -Vec3_Dot(FaceNormal, Get_SunLight().LightDirection);
+
+			// Calculate the resulting triangle color based on the light angle (the same for all the triangles left after clipping)
+			FaceColor = Light_Apply_Intensity(CurrentFace.color, LightIntensityFactor);
+		}
+
 		///////////////  CLIPPING  ///////////////
 
-		// Create a polygon from the original transformed triangle to be clipped
-		polygon_t Polygon = Polygon_From_Triangle(
-			&TransformedVertices[0], &TransformedVertices[1], &TransformedVertices[2],
-			&CurrentFace.aUV, &CurrentFace.bUV, &CurrentFace.cUV
-		);
-		// Clip the polygon and return a new one with potential new vertices
-		Clip_Polygon(&Polygon);
+		if (bClipSpace)
+		{
+			// The distances to all the clip space planes are computed once per vertex, for the outcodes and the clipping
+			Clip_Polygon_From_Triangle(&ClipPolygon,
+				&ClipSpaceVertices[0], &ClipSpaceVertices[1], &ClipSpaceVertices[2],
+				&CurrentFace.aUV, &CurrentFace.bUV, &CurrentFace.cUV
+			);
+			int TriangleClipClass = Classify_Clip_Polygon(&ClipPolygon);
+			Add_Triangle_Clip_Class(TriangleClipClass);
+
+			// Bypass the triangles that are completely outside the frustum
+			if (TriangleClipClass == TRIANGLE_REJECTED)
+			{
+				continue;
+			}
+			if (TriangleClipClass == TRIANGLE_CLIPPED)
+			{
+				Clip_Polygon_Homogeneous(&ClipPolygon);
+			}
+
+			// Project each vertex of the polygon once, and write its triangles straight into the ones to render
+			Project_Clip_Polygon(&ClipPolygon, WindowWidth, WindowHeight);
+			int FirstNewTriangle = NumTrianglesToRender;
+			int NumNewTriangles = Triangles_From_Clip_Polygon(&ClipPolygon,
+				&TrianglesToRender[FirstNewTriangle], MAX_TRIANGLES_PER_MESH - FirstNewTriangle);
+			for (int tri = 0; tri < NumNewTriangles; tri++)
+			{
+				Triangle_t* NewTriangle = &TrianglesToRender[NumTrianglesToRender];
+				if (NumTrianglesToRender != FirstNewTriangle + tri)
+				{
+					// Move it down over the culled ones
+					*NewTriangle = TrianglesToRender[FirstNewTriangle + tri];
+				}
+				if (bCullScreenArea && !Is_Projected_Triangle_Front_Facing(NewTriangle))
+				{
+					continue;
+				}
+				if (bCullSmallTriangles && !Is_Projected_Triangle_Visible(NewTriangle))
+				{
+					continue;
+				}
+				NewTriangle->color = FaceColor;
+				NewTriangle->texture = CurrentMesh->Texture;
+				NumTrianglesToRender++;
+			}
+			continue;
+		}
+
 		// Array of triangles returned by the clipped polygon
 		Triangle_t TrianglesAfterClipping[MAX_NUM_POLYGON_TRIANGLES];
 		int NumTrianglesAfterClipping = 0; // Counter of triangles returned by the clipped polygon
-		// Break the polygon back into triangles after clipping
-		Triangles_From_Polygon(&Polygon, TrianglesAfterClipping, &NumTrianglesAfterClipping);
+
+		// Use the outcodes of the vertices to skip the polygon clipper when it wouldn't change anything
+		int TriangleClipClass = Classify_Triangle(TransformedVertices);
+		Add_Triangle_Clip_Class(TriangleClipClass);
+
+		// Bypass the triangles that are completely outside the frustum
+		if (TriangleClipClass == TRIANGLE_REJECTED)
+		{
+			continue;
+		}
+
+		if (TriangleClipClass == TRIANGLE_ACCEPTED)
+		{
+			// Fully inside, so the triangle goes straight to projection
+			TrianglesAfterClipping[0].vertex[0] = TransformedVertices[0];
+			TrianglesAfterClipping[0].vertex[1] = TransformedVertices[1];
+			TrianglesAfterClipping[0].vertex[2] = TransformedVertices[2];
+			TrianglesAfterClipping[0].uvCoordinates[0] = CurrentFace.aUV;
+			TrianglesAfterClipping[0].uvCoordinates[1] = CurrentFace.bUV;
+			TrianglesAfterClipping[0].uvCoordinates[2] = CurrentFace.cUV;
+			NumTrianglesAfterClipping = 1;
+		}
+		else
+		{
+			// Create a polygon from the original transformed triangle to be clipped
+			polygon_t Polygon = Polygon_From_Triangle(
+				&TransformedVertices[0], &TransformedVertices[1], &TransformedVertices[2],
+				&CurrentFace.aUV, &CurrentFace.bUV, &CurrentFace.cUV
+			);
+			// Clip the polygon and return a new one with potential new vertices
+			Clip_Polygon(&Polygon);
+			// Break the polygon back into triangles after clipping
+			Triangles_From_Polygon(&Polygon, TrianglesAfterClipping, &NumTrianglesAfterClipping);
+		}
 
 		///////////////  END CLIPPING  ///////////////
 
@@ -423,15 +757,6 @@ void Process_Graphics_Pipeline_Stages(mesh_t* CurrentMesh)
 				ProjectedVertex[ind].y += (WindowHeight / 2.0);
 			}
 
-			/* SIMPLE FLAT (PER TRIANGLE FACE) SHADING */
-
-			// Calculate the shade intensity based on how aligned is the normal of a face with the inverse of the light ray
-			//Vec3_Normalize(&SunLight.LightDirection);
-			float LightIntensityFactor = -Vec3_Dot(FaceNormal, Get_SunLight().LightDirection);
-
-			// Calculate the resulting triangle color based on the light angle
-			CurrentFace.color = Light_Apply_Intensity(CurrentFace.color, LightIntensityFactor);
-
 			Triangle_t CurrentTriToRender =
 			{
 				.vertex =
@@ -446,10 +771,20 @@ void Process_Graphics_Pipeline_Stages(mesh_t* CurrentMesh)
 					{TriangleAfterClipping.uvCoordinates[1].u, TriangleAfterClipping.uvCoordinates[1].v},
 					{TriangleAfterClipping.uvCoordinates[2].u, TriangleAfterClipping.uvCoordinates[2].v}
 				},
-				.color = CurrentFace.color,
+				.color = FaceColor,
 				.texture = CurrentMesh->Texture
 			};
 
+			if (bCullScreenArea && !Is_Projected_Triangle_Front_Facing(&CurrentTriToRender))
+			{
+				continue;
+			}
+
+			if (bCullSmallTriangles && !Is_Projected_Triangle_Visible(&CurrentTriToRender))
+			{
+				continue;
+			}
+
 			if (NumTrianglesToRender < MAX_TRIANGLES_PER_MESH)
 			{
 				// Save the projection in the triangles array
@@ -509,67 +844,319 @@ void Update(void)
 		Process_Graphics_Pipeline_Stages(CurrentMesh);
 	}
 
+	// Closest triangles first, so the depth test rejects the hidden pixels before shading them
+	if (Is_Front_To_Back())
+	{
+		Sort_Triangles_Front_To_Back(TrianglesToRender, NumTrianglesToRender);
+	}
+
+	// Setup stage: one record per triangle, in the final order, so the rasterizers only have to read them
+	if (Uses_Triangle_Setups())
+	{
+		Begin_Setup_Timer();
+		Setup_Triangles(TrianglesToRender, NumTrianglesToRender, Should_Render_Textured_Triangles());
+		End_Setup_Timer();
+	}
+	else
+	{
+		Clear_Triangle_Setups();
+	}
 }
 
-void Render_Mode_Selector(Triangle_t CurrentTriangle)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Draw each part of a triangle (the render modes are combinations of them)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SDL_FORCE_INLINE void Draw_Triangle_Wireframe_Part(const Triangle_t* CurrentTriangle)
 {
-	// Draw filled triangles for each face 
-	if (Should_Render_Fill_Triangles())
+	// Parameter "DrawingMethod" = 0 is DDA Line Rasterization Algorithm, = 1 is Bresenham's
+	Draw_Triangle
+	(
+		CurrentTriangle->vertex[0].x, CurrentTriangle->vertex[0].y, // Vertex A
+		CurrentTriangle->vertex[1].x, CurrentTriangle->vertex[1].y, // Vertex B
+		CurrentTriangle->vertex[2].x, CurrentTriangle->vertex[2].y, // Vertex C
+		0xFFFFFFFF, // Color
+		1 // DrawingMethod
+	);
+}
+
+SDL_FORCE_INLINE void Draw_Triangle_Vertices_Part(const Triangle_t* CurrentTriangle)
+{
+	// Draw rectangles for each projected triangle vertex, translated to the middle of the screen
+	Draw_Rectangle(CurrentTriangle->vertex[0].x, CurrentTriangle->vertex[0].y, 6, 6, 0xFFFF0000);
+	Draw_Rectangle(CurrentTriangle->vertex[1].x, CurrentTriangle->vertex[1].y, 6, 6, 0xFFFF0000);
+	Draw_Rectangle(CurrentTriangle->vertex[2].x, CurrentTriangle->vertex[2].y, 6, 6, 0xFFFF0000);
+}
+
+// The edge function parts draw the setup record of the triangle when there's one (NULL sets the triangle up here)
+SDL_FORCE_INLINE void Draw_Triangle_Fill_Part_Edge_Function(const Triangle_t* CurrentTriangle, const triangle_setup_t* Setup)
+{
+	if (Setup)
 	{
-		// Parameter "DrawingMethod" = 0 is DDA Line Rasterization Algorithm, = 1 is Bresenham's
-		Draw_Filled_Triangle
-		(
-			// Vertex A
-			CurrentTriangle.vertex[0].x, CurrentTriangle.vertex[0].y, CurrentTriangle.vertex[0].z, CurrentTriangle.vertex[0].w,
-			// Vertex B
-			CurrentTriangle.vertex[1].x, CurrentTriangle.vertex[1].y, CurrentTriangle.vertex[1].z, CurrentTriangle.vertex[1].w,
-			// Vertex C
-			CurrentTriangle.vertex[2].x, CurrentTriangle.vertex[2].y, CurrentTriangle.vertex[2].z, CurrentTriangle.vertex[2].w,
-			CurrentTriangle.color // Color
-		);
+		Draw_Triangle_Setup(Setup);
+		return;
 	}
+	Draw_Filled_Triangle_Edge_Function
+	(
+		CurrentTriangle->vertex[0], CurrentTriangle->vertex[1], CurrentTriangle->vertex[2],
+		CurrentTriangle->color // Color
+	);
+}
 
-	// Draw wireframe triangles for each face 
+// The scanline rasterizer has no setup records
+SDL_FORCE_INLINE void Draw_Triangle_Fill_Part_Scanline(const Triangle_t* CurrentTriangle, const triangle_setup_t* Setup)
+{
+	(void)Setup;
+	// Parameter "DrawingMethod" = 0 is DDA Line Rasterization Algorithm, = 1 is Bresenham's
+	Draw_Filled_Triangle
+	(
+		// Vertex A
+		CurrentTriangle->vertex[0].x, CurrentTriangle->vertex[0].y, CurrentTriangle->vertex[0].z, CurrentTriangle->vertex[0].w,
+		// Vertex B
+		CurrentTriangle->vertex[1].x, CurrentTriangle->vertex[1].y, CurrentTriangle->vertex[1].z, CurrentTriangle->vertex[1].w,
+		// Vertex C
+		CurrentTriangle->vertex[2].x, CurrentTriangle->vertex[2].y, CurrentTriangle->vertex[2].z, CurrentTriangle->vertex[2].w,
+		CurrentTriangle->color // Color
+	);
+}
+
+SDL_FORCE_INLINE void Draw_Triangle_Textured_Part_Edge_Function(const Triangle_t* CurrentTriangle, const triangle_setup_t* Setup)
+{
+	if (Setup)
+	{
+		Draw_Triangle_Setup(Setup);
+		return;
+	}
+	Draw_Textured_Triangle_Edge_Function
+	(
+		CurrentTriangle->vertex[0], CurrentTriangle->vertex[1], CurrentTriangle->vertex[2],
+		CurrentTriangle->uvCoordinates[0], CurrentTriangle->uvCoordinates[1], CurrentTriangle->uvCoordinates[2],
+		CurrentTriangle->texture
+	);
+}
+
+SDL_FORCE_INLINE void Draw_Triangle_Textured_Part_Scanline(const Triangle_t* CurrentTriangle, const triangle_setup_t* Setup)
+{
+	(void)Setup;
+	// If you don't want perspective correct interpolation, you don't need to pass the Z and W components
+	Draw_Textured_Triangle
+	(
+		// Vertex A
+		CurrentTriangle->vertex[0].x, CurrentTriangle->vertex[0].y, CurrentTriangle->vertex[0].z, CurrentTriangle->vertex[0].w,
+		// Vertex B
+		CurrentTriangle->vertex[1].x, CurrentTriangle->vertex[1].y, CurrentTriangle->vertex[1].z, CurrentTriangle->vertex[1].w,
+		// Vertex C
+		CurrentTriangle->vertex[2].x, CurrentTriangle->vertex[2].y, CurrentTriangle->vertex[2].z, CurrentTriangle->vertex[2].w,
+		CurrentTriangle->uvCoordinates[0].u, CurrentTriangle->uvCoordinates[0].v, // UV Vertex A
+		CurrentTriangle->uvCoordinates[1].u, CurrentTriangle->uvCoordinates[1].v, // UV Vertex B
+		CurrentTriangle->uvCoordinates[2].u, CurrentTriangle->uvCoordinates[2].v, // UV Vertex C
+		CurrentTriangle->texture
+	);
+}
+
+void Render_Triangle_Wireframe(Triangle_t CurrentTriangle)
+{
 	if (Should_Render_Wireframe_Triangles())
 	{
-		// Parameter "DrawingMethod" = 0 is DDA Line Rasterization Algorithm, = 1 is Bresenham's
-		Draw_Triangle
-		(
-			CurrentTriangle.vertex[0].x, CurrentTriangle.vertex[0].y, // Vertex A
-			CurrentTriangle.vertex[1].x, CurrentTriangle.vertex[1].y, // Vertex B
-			CurrentTriangle.vertex[2].x, CurrentTriangle.vertex[2].y, // Vertex C
-			0xFFFFFFFF, // Color
-			1 // DrawingMethod
-		);
+		Draw_Triangle_Wireframe_Part(&CurrentTriangle);
+	}
+}
+
+void Render_Triangle_Vertices(Triangle_t CurrentTriangle)
+{
+	if (Should_Render_Triangle_Vertices())
+	{
+		Draw_Triangle_Vertices_Part(&CurrentTriangle);
+	}
+}
+
+// Generic path: checks the render and raster modes for every triangle
+void Render_Mode_Selector(Triangle_t CurrentTriangle)
+{
+	// Draw filled triangles for each face 
+	if (Should_Render_Fill_Triangles() && Is_Raster_Edge_Function())
+	{
+		Draw_Triangle_Fill_Part_Edge_Function(&CurrentTriangle, NULL);
+	}
+	else if (Should_Render_Fill_Triangles())
+	{
+		Draw_Triangle_Fill_Part_Scanline(&CurrentTriangle, NULL);
 	}
 
+	// Draw wireframe triangles for each face 
+	Render_Triangle_Wireframe(CurrentTriangle);
+
 	// Draw textured triangles for each face 
-	if (Should_Render_Textured_Triangles())
-	{
-		// If you don't want perspective correct interpolation, you don't need to pass the Z and W components
-		Draw_Textured_Triangle
-		(
-			// Vertex A
-			CurrentTriangle.vertex[0].x, CurrentTriangle.vertex[0].y, CurrentTriangle.vertex[0].z, CurrentTriangle.vertex[0].w,
-			// Vertex B
-			CurrentTriangle.vertex[1].x, CurrentTriangle.vertex[1].y, CurrentTriangle.vertex[1].z, CurrentTriangle.vertex[1].w,
-			// Vertex C
-			CurrentTriangle.vertex[2].x, CurrentTriangle.vertex[2].y, CurrentTriangle.vertex[2].z, CurrentTriangle.vertex[2].w,
-			CurrentTriangle.uvCoordinates[0].u, CurrentTriangle.uvCoordinates[0].v, // UV Vertex A
-			CurrentTriangle.uvCoordinates[1].u, CurrentTriangle.uvCoordinates[1].v, // UV Vertex B
-			CurrentTriangle.uvCoordinates[2].u, CurrentTriangle.uvCoordinates[2].v, // UV Vertex C
-			CurrentTriangle.texture
-		);
+	if (Should_Render_Textured_Triangles() && Is_Raster_Edge_Function())
+	{
+		Draw_Triangle_Textured_Part_Edge_Function(&CurrentTriangle, NULL);
+	}
+	else if (Should_Render_Textured_Triangles())
+	{
+		Draw_Triangle_Textured_Part_Scanline(&CurrentTriangle, NULL);
 	}
 
 	// Draw triangle vertex points for each face
-	if (Should_Render_Triangle_Vertices())
+	Render_Triangle_Vertices(CurrentTriangle);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Triangle renderers specialized for each render mode and rasterizer, generated from RENDER_MODE_LIST
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The parts of each mode are constants, so every variant only contains its own draw calls, in the same order as
+// Render_Mode_Selector. Get_Triangle_Renderer picks one of them once per frame, instead of checking the modes
+// for every triangle. The cull mode doesn't need variants: the culling already happened in the geometry stage.
+// Setup is the record of the triangle built by the setup stage, or NULL when there are no records this frame
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef void (*triangle_renderer_t)(const Triangle_t* CurrentTriangle, const triangle_setup_t* Setup);
+
+#define DEFINE_TRIANGLE_RENDERER(Name, Raster, bFill, bTextured, bWireframe, bVertices) \
+	void Render_Triangle_##Name##_##Raster(const Triangle_t* CurrentTriangle, const triangle_setup_t* Setup) \
+	{ \
+		if (bFill) { Draw_Triangle_Fill_Part_##Raster(CurrentTriangle, Setup); } \
+		if (bWireframe) { Draw_Triangle_Wireframe_Part(CurrentTriangle); } \
+		if (bTextured) { Draw_Triangle_Textured_Part_##Raster(CurrentTriangle, Setup); } \
+		if (bVertices) { Draw_Triangle_Vertices_Part(CurrentTriangle); } \
+	}
+
+#define DEFINE_TRIANGLE_RENDERERS(Mode, Name, bFill, bTextured, bWireframe, bVertices) \
+	DEFINE_TRIANGLE_RENDERER(Name, Scanline, bFill, bTextured, bWireframe, bVertices) \
+	DEFINE_TRIANGLE_RENDERER(Name, Edge_Function, bFill, bTextured, bWireframe, bVertices)
+
+RENDER_MODE_LIST(DEFINE_TRIANGLE_RENDERERS)
+
+#define SCANLINE_TRIANGLE_RENDERER(Mode, Name, bFill, bTextured, bWireframe, bVertices) [Mode] = Render_Triangle_##Name##_Scanline,
+#define EDGE_FUNCTION_TRIANGLE_RENDERER(Mode, Name, bFill, bTextured, bWireframe, bVertices) [Mode] = Render_Triangle_##Name##_Edge_Function,
+
+const triangle_renderer_t ScanlineTriangleRenderers[NUM_RENDER_MODES] = { RENDER_MODE_LIST(SCANLINE_TRIANGLE_RENDERER) };
+const triangle_renderer_t EdgeFunctionTriangleRenderers[NUM_RENDER_MODES] = { RENDER_MODE_LIST(EDGE_FUNCTION_TRIANGLE_RENDERER) };
+
+triangle_renderer_t Get_Triangle_Renderer(void)
+{
+	// Both edge function modes share the variants, Draw_*_Edge_Function pick the scalar or SIMD block loops
+	if (Is_Raster_Edge_Function())
+	{
+		return EdgeFunctionTriangleRenderers[Get_Render_Mode()];
+	}
+	return ScanlineTriangleRenderers[Get_Render_Mode()];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Draw the wireframe and vertices of all the triangles, over the faces that were already drawn
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Render_Triangle_Overlays(void)
+{
+	for (int idx = 0; idx < NumTrianglesToRender; idx++)
+	{
+		Render_Triangle_Wireframe(TrianglesToRender[idx]);
+		Render_Triangle_Vertices(TrianglesToRender[idx]);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Render the filled/textured triangles with all the threads (by screen tiles or by interleaved bands of scanlines)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Render_Parallel(void)
+{
+	bool bIsTextured = Should_Render_Textured_Triangles();
+
+	if (Should_Render_Fill_Triangles() || bIsTextured)
+	{
+		if (Is_Parallel_Tiles())
+		{
+			Begin_Tile_Binning();
+			for (int idx = 0; idx < Get_Num_Triangle_Setups(); idx++)
+			{
+				Bin_Triangle_Setup(idx);
+			}
+			Rasterize_Tiles(CLEAR_COLOR);
+		}
+		else
+		{
+			Rasterize_Interleaved(bIsTextured);
+		}
+	}
+
+	// Lines and vertices aren't parallelized, so they're drawn afterwards (over the faces) by the main thread
+	Render_Triangle_Overlays();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Render the textured triangles in the main thread with a depth pre-pass: first only their depth, then the texels of the
+// pixels that ended up with exactly their depth, so each visible pixel is textured once no matter the order of the triangles
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Render_Depth_Prepass(void)
+{
+	for (int Pass = RASTER_PASS_DEPTH_ONLY; Pass <= RASTER_PASS_EQUAL_DEPTH; Pass++)
+	{
+		// Both passes read the same setup records
+		for (int idx = 0; idx < Get_Num_Triangle_Setups(); idx++)
+		{
+			const triangle_setup_t* Setup = Get_Triangle_Setup(idx);
+			if (!Is_Triangle_Setup_Empty(Setup))
+			{
+				Add_Shaded_Pixels(Rasterize_Triangle_Rect(Setup, Get_Screen_Target(), Pass, Setup->MinX, Setup->MinY, Setup->MaxX, Setup->MaxY));
+			}
+		}
+	}
+
+	Render_Triangle_Overlays();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Check if a sky dome covers every pixel of the screen this frame, so the color clear can be skipped
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	From anywhere inside its inner sphere, every ray of the camera hits a sky dome, as long as:
+	- Its triangles are filled or textured, by a watertight rasterizer: the edge functions or the span buffer (the
+	  scanlines can leave gaps between neighbour triangles)
+	- No part of the dome gets clipped: the inner sphere is beyond the near plane, and the outer one inside the far plane
+	The faces look inwards, so neither culling mode removes the ones around the camera.
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool Is_Screen_Covered_By_Sky_Dome(void)
+{
+	if (!(Should_Render_Fill_Triangles() || Should_Render_Textured_Triangles()) || !(Is_Raster_Edge_Function() || Is_Span_Buffer()))
 	{
-		// Draw rectangles for each projected triangle vertex, translated to the middle of the screen
-		Draw_Rectangle(CurrentTriangle.vertex[0].x, CurrentTriangle.vertex[0].y, 6, 6, 0xFFFF0000);
-		Draw_Rectangle(CurrentTriangle.vertex[1].x, CurrentTriangle.vertex[1].y, 6, 6, 0xFFFF0000);
-		Draw_Rectangle(CurrentTriangle.vertex[2].x, CurrentTriangle.vertex[2].y, 6, 6, 0xFFFF0000);
+		return false;
 	}
+
+	vec3_t CameraPosition = Get_Camera_Position();
+	for (int idx = 0; idx < Get_Num_Meshes(); idx++)
+	{
+		mesh_t* Mesh = Get_Mesh(idx);
+		if (!Mesh->bIsSkyDome)
+		{
+			continue;
+		}
+
+		// Scaling grows the spheres at least by the smallest factor and at most by the biggest one (rotations don't change them)
+		float MinScale = fminf(Mesh->Scale.x, fminf(Mesh->Scale.y, Mesh->Scale.z));
+		float MaxScale = fmaxf(Mesh->Scale.x, fmaxf(Mesh->Scale.y, Mesh->Scale.z));
+		float Distance = Vec3_Length(Vec3_Subtract(Mesh->Position, CameraPosition));
+
+		if ((Mesh->InnerRadius * MinScale) - Distance > SkyDomeMinDistance && (Mesh->OuterRadius * MaxScale) + Distance < SkyDomeMaxDistance)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Check if this frame goes through the tile buffers: they write every pixel of the screen, so nothing has to be cleared
+// (it's the same path Render and Render_Parallel take with the screen tiles)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool Is_Rendering_Tile_Buffers(void)
+{
+	bool bFaces = Should_Render_Fill_Triangles() || Should_Render_Textured_Triangles();
+	return bFaces && Is_Tile_Buffers() && Is_Parallel_Tiles() && Is_Raster_Edge_Function() && !Is_Span_Buffer() && !Is_Visibility_Buffer();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -585,31 +1172,127 @@ void Render(void)
 	// Clear the renderer with the choosed color 
 	//SDL_RenderClear(Renderer);
 
-	Clear_ColorBuffer(0x0000000);
-	Clear_ZBuffer();
+	// The tile buffers start cleared, and keep their depths to themselves
+	if (Is_Rendering_Tile_Buffers())
+	{
+		Skip_ZBuffer_Clear();
+	}
+	else
+	{
+		// When a sky dome covers every pixel, all of them get a new color anyway
+		if (!Is_Clear_Elision() || !Is_Screen_Covered_By_Sky_Dome())
+		{
+			Clear_ColorBuffer(CLEAR_COLOR);
+		}
+		Clear_ZBuffer();
+	}
+
+	Begin_Raster_Timer();
 
-	// Loop all the projected triangles and render them
-	for (int idx = 0; idx < NumTrianglesToRender; idx++)
+	if (Is_Span_Buffer() && (Should_Render_Fill_Triangles() || Should_Render_Textured_Triangles()))
+	{
+		Render_Span_Buffer();
+		Render_Triangle_Overlays();
+	}
+	else if (Is_Visibility_Buffer() && Is_Raster_Edge_Function() && (Should_Render_Fill_Triangles() || Should_Render_Textured_Triangles()))
+	{
+		Render_Visibility_Buffer();
+		Render_Triangle_Overlays();
+	}
+	else if ((Is_Parallel_Tiles() || Is_Parallel_Interleaved()) && Is_Raster_Edge_Function())
+	{
+		Render_Parallel();
+	}
+	else if (Is_Depth_Prepass() && Should_Render_Textured_Triangles() && Is_Raster_Edge_Function())
+	{
+		Render_Depth_Prepass();
+	}
+	else if (Is_Specialized_Renderers())
+	{
+		// Pick the renderer of the current modes once, and call it for all the projected triangles
+		triangle_renderer_t Render_Triangle = Get_Triangle_Renderer();
+		for (int idx = 0; idx < NumTrianglesToRender; idx++)
+		{
+			Render_Triangle(&TrianglesToRender[idx], Get_Triangle_Setup(idx));
+		}
+	}
+	else
 	{
-		Triangle_t CurrentTriangle = TrianglesToRender[idx];
+		// Loop all the projected triangles and render them
+		for (int idx = 0; idx < NumTrianglesToRender; idx++)
+		{
+			Triangle_t CurrentTriangle = TrianglesToRender[idx];
 
-		Render_Mode_Selector(CurrentTriangle);
+			Render_Mode_Selector(CurrentTriangle);
+		}
 	}
 
+	End_Raster_Timer();
+	Report_Frame_Stats(Get_Raster_Mode_Name(), Get_Parallel_Mode_Name());
+
 	//Draw_Grid(10, 0xFF333333);
 	// Update the screen, presenting the backbuffer that contains the stuff you want to draw
 	Render_ColorBuffer();
+
+	// The next frame stores its depths in the next generation (if they're enabled)
+	Advance_Depth_Generation();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Main function
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// The depth buffer format comes from the command line: --depth16 or --depth24 for the integer ones (float by default)
+static int Parse_Depth_Format(int argc, char* args[])
+{
+	int DepthFormat = DEPTH_FORMAT_FLOAT32;
+	for (int idx = 1; idx < argc; idx++)
+	{
+		if (SDL_strcmp(args[idx], "--depth16") == 0)
+		{
+			DepthFormat = DEPTH_FORMAT_UNORM16;
+		}
+		else if (SDL_strcmp(args[idx], "--depth24") == 0)
+		{
+			DepthFormat = DEPTH_FORMAT_UNORM24;
+		}
+		else if (SDL_strcmp(args[idx], "--depth32f") == 0)
+		{
+			DepthFormat = DEPTH_FORMAT_FLOAT32;
+		}
+	}
+	return DepthFormat;
+}
+
+// --report-reciprocal tells how far the fast reciprocal of a FAST_RECIPROCAL build is from the exact divisions
+// It tests every float mantissa, so it's only done when asked for
+static bool Parse_Report_Reciprocal(int argc, char* args[])
+{
+	for (int idx = 1; idx < argc; idx++)
+	{
+		if (SDL_strcmp(args[idx], "--report-reciprocal") == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 int main(int argc, char* args[])
 {
-	bIsRunning = Initialize_Window();
+	bIsRunning = Initialize_Window(Parse_Depth_Format(argc, args));
+	bIsRunning = bIsRunning && Initialize_Raster_Threads() && Initialize_Tiles() && Initialize_Span_Buffer();
 	Setup();
 
+	if (Parse_Report_Reciprocal(argc, args))
+	{
+#if defined(INTERPOLATION_FAST_RECIPROCAL)
+		Report_Fast_Reciprocal_Accuracy();
+#else
+		printf("--report-reciprocal: this build doesn't use the fast reciprocal (see FAST_RECIPROCAL)\n");
+#endif
+	}
+
 	while (bIsRunning)
 	{
 		Process_Input();
@@ -617,6 +1300,11 @@ int main(int argc, char* args[])
 		Render();
 	}
 
+	Destroy_Span_Buffer();
+	Destroy_Triangle_Setups();
+	Destroy_Depth_Sort();
+	Destroy_Tiles();
+	Destroy_Raster_Threads();
 	Destroy_Window();
 	Free_Meshes();
 
@@ -199,14 +199,31 @@ vec4_t Mat4_Multiply_Vec4_Projection(mat4_t ProjectionMatrix, vec4_t Vector)
 	// Multiply the projection matrix by the original vector
 	vec4_t Result = Mat4_Multiply_Vec4(ProjectionMatrix, Vector);
 
+	return Vec4_Perspective_Divide(Result);
+}
+
+vec4_t Vec4_Perspective_Divide(vec4_t Vector)
+{
 	// Perform perspective divide with the original Z value stored in W
-	if (Result.w != 0)
+	if (Vector.w != 0)
 	{
-		Result.x /= Result.w;
-		Result.y /= Result.w;
-		Result.z /= Result.w;
+		Vector.x /= Vector.w;
+		Vector.y /= Vector.w;
+		Vector.z /= Vector.w;
 	}
 
+	return Vector;
+}
+
+vec4_t Mat4_Clip_To_Camera_Space(mat4_t ProjectionMatrix, vec4_t Vector)
+{
+	vec4_t Result =
+	{
+		.x = Vector.x / ProjectionMatrix.matrix[0][0],
+		.y = Vector.y / ProjectionMatrix.matrix[1][1],
+		.z = Vector.w,
+		.w = 1
+	};
 	return Result;
 }
 
@@ -43,6 +43,13 @@ mat4_t Mat4_Make_PerspectiveProjection(float FOV, float AspectRatio, float ZNear
 
 vec4_t Mat4_Multiply_Vec4_Projection	(mat4_t ProjectionMatrix, vec4_t Vector);
 
+// Divide x, y and z of a clip space vector by its w (w keeps the original camera space Z value)
+vec4_t Vec4_Perspective_Divide(vec4_t Vector);
+
+// Get back the camera space position of a clip space vector made with Mat4_Make_PerspectiveProjection
+// That projection only scales x and y, and copies the camera space z into w
+vec4_t Mat4_Clip_To_Camera_Space(mat4_t ProjectionMatrix, vec4_t Vector);
+
 // Compute the Look At function
 mat4_t Mat4_Look_At(vec3_t CameraEye, vec3_t LookTarget, vec3_t UpVector);
 
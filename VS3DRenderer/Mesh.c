@@ -1,6 +1,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <float.h>
+#include <math.h>
 #include "Array.h"
 #include "Vector.h"
 #include "Mesh.h"
@@ -260,6 +262,45 @@ void Rotate_Mesh_Euler(int Index, vec3_t Rot)
 	Meshes[Index].Rotation = Vec3_Add(Meshes[Index].Rotation, Rot);
 }
 
+void Set_Mesh_Sky_Dome(int Index)
+{
+	mesh_t* Mesh = &Meshes[Index];
+	Mesh->bIsSkyDome = true;
+
+	// The mesh is convex and closed around the origin, so the closest face plane to the origin limits the sphere that
+	// fits inside. Without faces (the OBJ file couldn't be opened) there's nothing to cover the screen with
+	int NumFaces = Array_Length(Mesh->Faces);
+	Mesh->InnerRadius = (NumFaces > 0) ? FLT_MAX : 0.0f;
+	for (int idx = 0; idx < NumFaces; idx++)
+	{
+		vec3_t A = Mesh->Vertices[Mesh->Faces[idx].a];
+		vec3_t B = Mesh->Vertices[Mesh->Faces[idx].b];
+		vec3_t C = Mesh->Vertices[Mesh->Faces[idx].c];
+
+		vec3_t Normal = Vec3_Cross(Vec3_Subtract(B, A), Vec3_Subtract(C, A));
+		float NormalLength = Vec3_Length(Normal);
+		if (NormalLength > 0.0f)
+		{
+			// Same winding as the backface culling: a face looks inwards when the origin is in front of it. One that
+			// looks outwards gets culled from inside and leaves a hole, so the clear can never be skipped for this mesh
+			float InwardDistance = -Vec3_Dot(Normal, A) / NormalLength;
+			if (InwardDistance <= 0.0f)
+			{
+				Mesh->InnerRadius = 0.0f;
+				break;
+			}
+			Mesh->InnerRadius = fminf(Mesh->InnerRadius, InwardDistance);
+		}
+	}
+
+	Mesh->OuterRadius = 0.0f;
+	int NumVertices = Array_Length(Mesh->Vertices);
+	for (int idx = 0; idx < NumVertices; idx++)
+	{
+		Mesh->OuterRadius = fmaxf(Mesh->OuterRadius, Vec3_Length(Mesh->Vertices[idx]));
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Free the memory that was dynamically allocated by the program
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
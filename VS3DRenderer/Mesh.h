@@ -38,6 +38,9 @@ typedef struct
 	vec3_t Rotation; // x, y, z values (euler angles) of mesh's rotation
 	vec3_t Scale; // x, y, z values of mesh's scale
 	vec3_t Position; // x, y, z values of mesh's position
+	bool bIsSkyDome; // Opaque, convex and closed around its origin, with the faces looking inwards (see Set_Mesh_Sky_Dome)
+	float InnerRadius; // Sky domes only: radius of the biggest sphere around the origin that fits inside the mesh
+	float OuterRadius; // Sky domes only: distance from the origin to the farthest vertex
 } mesh_t;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +57,11 @@ int Get_Num_Meshes(void);
 
 void Rotate_Mesh_Euler(int Index, vec3_t Rot);
 
+// Mark a mesh as a sky dome: from anywhere inside its inner sphere, it covers every pixel of the screen
+// The mesh must be convex, closed around its origin and with all its faces looking inwards, otherwise the inner radius
+// it computes isn't the real one: faces looking outwards leave it at 0, so the color clear is never skipped for it
+void Set_Mesh_Sky_Dome(int Index);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Free the memory that was dynamically allocated by the program
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <SDL.h>
+#include "RasterThreads.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Declare the worker threads and the semaphores to start/finish the jobs
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static SDL_Thread* Workers[MAX_RASTER_THREADS];
+static int WorkerIndices[MAX_RASTER_THREADS]; // ThreadIndex of each worker, passed as the thread data
+static int NumWorkers = 0; // Worker threads, not counting the main thread
+
+// Each worker has its own start semaphore: with a shared one, a fast worker could finish its part and take the
+// start meant for another worker, running its ThreadIndex twice while the other one never runs
+static SDL_sem* StartSemaphores[MAX_RASTER_THREADS];
+static SDL_sem* DoneSemaphore = NULL; // Posted by each worker when it finishes the job
+static raster_job_t CurrentJob = NULL;
+static SDL_atomic_t bQuitWorkers;
+
+static int Raster_Worker(void* Data)
+{
+	int ThreadIndex = *(int*)Data;
+
+	while (true)
+	{
+		SDL_SemWait(StartSemaphores[ThreadIndex - 1]);
+		if (SDL_AtomicGet(&bQuitWorkers))
+		{
+			break;
+		}
+
+		CurrentJob(ThreadIndex, NumWorkers + 1);
+		SDL_SemPost(DoneSemaphore);
+	}
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Initialize_Raster_Threads(void)
+{
+	DoneSemaphore = SDL_CreateSemaphore(0);
+	if (!DoneSemaphore)
+	{
+		fprintf(stderr, "Error creating the raster thread semaphore: %s\n", SDL_GetError());
+		return false;
+	}
+
+	SDL_AtomicSet(&bQuitWorkers, 0);
+
+	// One thread per logical core, the main thread included. If some thread can't be created, just use fewer of them
+	int NumThreads = SDL_GetCPUCount();
+	if (NumThreads > MAX_RASTER_THREADS)
+	{
+		NumThreads = MAX_RASTER_THREADS;
+	}
+
+	NumWorkers = 0;
+	for (int idx = 0; idx < NumThreads - 1; idx++)
+	{
+		StartSemaphores[NumWorkers] = SDL_CreateSemaphore(0);
+		if (!StartSemaphores[NumWorkers])
+		{
+			fprintf(stderr, "Error creating a raster thread semaphore: %s\n", SDL_GetError());
+			break;
+		}
+
+		// The main thread is index 0, so the workers start at 1
+		WorkerIndices[NumWorkers] = NumWorkers + 1;
+		Workers[NumWorkers] = SDL_CreateThread(Raster_Worker, "RasterWorker", &WorkerIndices[NumWorkers]);
+		if (!Workers[NumWorkers])
+		{
+			fprintf(stderr, "Error creating a raster thread: %s\n", SDL_GetError());
+			SDL_DestroySemaphore(StartSemaphores[NumWorkers]);
+			break;
+		}
+		NumWorkers++;
+	}
+
+	return true;
+}
+
+void Destroy_Raster_Threads(void)
+{
+	// Wake up every worker with the quit flag set, and wait for them to finish
+	SDL_AtomicSet(&bQuitWorkers, 1);
+	for (int idx = 0; idx < NumWorkers; idx++)
+	{
+		SDL_SemPost(StartSemaphores[idx]);
+	}
+	for (int idx = 0; idx < NumWorkers; idx++)
+	{
+		SDL_WaitThread(Workers[idx], NULL);
+		SDL_DestroySemaphore(StartSemaphores[idx]);
+	}
+	NumWorkers = 0;
+
+	if (DoneSemaphore) SDL_DestroySemaphore(DoneSemaphore);
+	DoneSemaphore = NULL;
+}
+
+void Run_Raster_Job(raster_job_t Job)
+{
+	// The semaphores also make sure the workers see everything the main thread wrote before the job (bins, setups...)
+	// and the main thread sees all the pixels written by the workers after it
+	CurrentJob = Job;
+	for (int idx = 0; idx < NumWorkers; idx++)
+	{
+		SDL_SemPost(StartSemaphores[idx]);
+	}
+
+	// The main thread does its part too, instead of just waiting
+	Job(0, NumWorkers + 1);
+
+	for (int idx = 0; idx < NumWorkers; idx++)
+	{
+		SDL_SemWait(DoneSemaphore);
+	}
+}
+
+int Get_Raster_Thread_Count(void)
+{
+	return NumWorkers + 1;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#ifndef RASTER_THREADS_H
+#define RASTER_THREADS_H
+
+#include <stdbool.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pool of threads shared by the parallel raster modes (tiles and interleaved bands)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The worker threads sleep on a semaphore until there's a job. A job runs once in every thread (the main thread
+// included), each one with a different ThreadIndex, and the main thread waits until all of them are done
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Maximum number of threads rasterizing at the same time (the main thread is one of them)
+#define MAX_RASTER_THREADS 64
+
+// ThreadIndex goes from 0 (the main thread) to NumThreads - 1
+typedef void (*raster_job_t)(int ThreadIndex, int NumThreads);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Start one worker thread per logical core, minus the main thread
+bool Initialize_Raster_Threads(void);
+
+// Stop the worker threads
+void Destroy_Raster_Threads(void);
+
+// Run the job in all the threads and wait until every one of them returns
+void Run_Raster_Job(raster_job_t Job);
+
+// Number of threads that run each job, including the main thread
+int Get_Raster_Thread_Count(void);
+
+#endif // !RASTER_THREADS_H
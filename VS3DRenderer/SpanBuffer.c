@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <SDL.h>
+#include "Array.h"
+#include "Display.h"
+#include "RasterThreads.h"
+#include "Stats.h"
+#include "SpanBuffer.h"
+#include "TriangleSetups.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Declare the spans, the triangles of the frame and the scanline bins
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	int X0; // First and last pixel of the span (both included)
+	int X1;
+	int Setup; // Index of the setup record of the triangle that's visible along the span
+} span_t;
+
+static int** RowBins = NULL; // One dynamic array per scanline, with the setup record indices of the triangles crossing it
+static int NumBinned = 0; // Setup records binned this frame
+static int NumRows = 0;
+
+// Each thread builds the span list of one scanline at a time, switching between 2 dynamic arrays on every insertion
+static span_t* ThreadSpans[MAX_RASTER_THREADS][2];
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pixels of row y that are inside the 3 edges of the triangle (the same ones the edge function rasterizer draws)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool Get_Triangle_Span(const triangle_setup_t* Setup, int y, int* X0, int* X1)
+{
+	int FirstX = Setup->MinX;
+	int LastX = Setup->MaxX;
+
+	for (int idx = 0; idx < 3; idx++)
+	{
+		const edge_equation_t* Edge = &Setup->Edges[idx];
+		int64_t Value = Edge_Equation_At(Edge, Setup, Setup->MinX, y);
+
+		if (Edge->StepX > 0)
+		{
+			// Growing to the right: inside from the first pixel where Value + StepX * k >= 0
+			if (Value < 0)
+			{
+				FirstX = SDL_max(FirstX, Setup->MinX + (int)((-Value + Edge->StepX - 1) / Edge->StepX));
+			}
+		}
+		else if (Edge->StepX < 0)
+		{
+			// Shrinking to the right: inside until the last pixel where Value + StepX * k >= 0
+			if (Value < 0)
+			{
+				return false;
+			}
+			LastX = SDL_min(LastX, Setup->MinX + (int)(Value / -Edge->StepX));
+		}
+		else if (Value < 0)
+		{
+			// Horizontal edge, the whole row is outside
+			return false;
+		}
+	}
+
+	*X0 = FirstX;
+	*X1 = LastX;
+	return FirstX <= LastX;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pixels of [X0, X1] where the new triangle is strictly closer than the old one (the same test as the depth buffer)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool Get_Closer_Range(const triangle_setup_t* New, const triangle_setup_t* Old, int y, int X0, int X1, int* CloserX0, int* CloserX1)
+{
+	// Closer means bigger 1/W, and the difference of both 1/W changes linearly along the row
+	float Difference0 = Plane_Equation_At(&New->ReciprocalW, New, X0, y) - Plane_Equation_At(&Old->ReciprocalW, Old, X0, y);
+	float DifferenceStep = New->ReciprocalW.StepX - Old->ReciprocalW.StepX;
+	float Difference1 = Difference0 + (DifferenceStep * (X1 - X0));
+
+	if (Difference0 > 0 && Difference1 > 0)
+	{
+		*CloserX0 = X0;
+		*CloserX1 = X1;
+		return true;
+	}
+	if (Difference0 <= 0 && Difference1 <= 0)
+	{
+		return false;
+	}
+
+	// The signs are different, so they cross somewhere inside the range (and the step can't be zero)
+	float Crossing = -Difference0 / DifferenceStep;
+	if (DifferenceStep > 0)
+	{
+		// The new triangle gets in front after the crossing
+		*CloserX0 = X0 + (int)floorf(Crossing) + 1;
+		*CloserX1 = X1;
+	}
+	else
+	{
+		// The new triangle goes behind after the crossing
+		*CloserX0 = X0;
+		*CloserX1 = X0 + (int)ceilf(Crossing) - 1;
+	}
+
+	*CloserX0 = SDL_max(*CloserX0, X0);
+	*CloserX1 = SDL_min(*CloserX1, X1);
+	return *CloserX0 <= *CloserX1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Append a span to the end of a list, merging it with the last one when they're contiguous pieces of the same triangle
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static span_t* Push_Span(span_t* Spans, int X0, int X1, int Setup)
+{
+	if (X0 > X1)
+	{
+		return Spans;
+	}
+
+	int NumSpans = Array_Length(Spans);
+	if (NumSpans > 0 && Spans[NumSpans - 1].Setup == Setup && Spans[NumSpans - 1].X1 + 1 == X0)
+	{
+		Spans[NumSpans - 1].X1 = X1;
+		return Spans;
+	}
+
+	span_t Span = { X0, X1, Setup };
+	Array_Push(Spans, Span);
+	return Spans;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Insert the span [X0, X1] of a triangle into the sorted list Spans, writing the resulting list into NewSpans
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static span_t* Insert_Span(const span_t* Spans, span_t* NewSpans, int X0, int X1, int Setup, int y)
+{
+	Array_Clear(NewSpans);
+
+	int NumSpans = Array_Length((void*)Spans);
+	int NextX = X0; // First pixel of the new span that isn't in the new list yet
+
+	for (int idx = 0; idx < NumSpans; idx++)
+	{
+		span_t Old = Spans[idx];
+
+		// No overlap: the old span is before the new one, or after it (and then the rest of the new span goes first)
+		if (Old.X1 < NextX || Old.X0 > X1)
+		{
+			if (Old.X0 > X1 && NextX <= X1)
+			{
+				NewSpans = Push_Span(NewSpans, NextX, X1, Setup);
+				NextX = X1 + 1;
+			}
+			NewSpans = Push_Span(NewSpans, Old.X0, Old.X1, Old.Setup);
+			continue;
+		}
+
+		// The gap before the old span only has the new triangle
+		NewSpans = Push_Span(NewSpans, NextX, Old.X0 - 1, Setup);
+
+		int OverlapX0 = SDL_max(Old.X0, NextX);
+		int OverlapX1 = SDL_min(Old.X1, X1);
+		NewSpans = Push_Span(NewSpans, Old.X0, OverlapX0 - 1, Old.Setup);
+
+		int CloserX0, CloserX1;
+		if (Get_Closer_Range(Get_Triangle_Setup(Setup), Get_Triangle_Setup(Old.Setup), y, OverlapX0, OverlapX1, &CloserX0, &CloserX1))
+		{
+			NewSpans = Push_Span(NewSpans, OverlapX0, CloserX0 - 1, Old.Setup);
+			NewSpans = Push_Span(NewSpans, CloserX0, CloserX1, Setup);
+			NewSpans = Push_Span(NewSpans, CloserX1 + 1, OverlapX1, Old.Setup);
+		}
+		else
+		{
+			NewSpans = Push_Span(NewSpans, OverlapX0, OverlapX1, Old.Setup);
+		}
+
+		NewSpans = Push_Span(NewSpans, OverlapX1 + 1, Old.X1, Old.Setup);
+		NextX = OverlapX1 + 1;
+	}
+
+	// Whatever is left of the new span is after every old span
+	return Push_Span(NewSpans, NextX, X1, Setup);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Shade the pixels of a visible span, writing each one exactly once
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void Shade_Span(const triangle_setup_t* Setup, int X0, int X1, int y)
+{
+	color_t* ColorBuffer = Get_ColorBuffer();
+	// Every pixel is written only once here (no depth test), so the format of the depth buffer is simply checked per pixel
+	void* ZBuffer = Get_ZBuffer();
+	int DepthFormat = Get_Depth_Format();
+	int RowIndex = Pixel_Row_Offset(y, Get_Buffer_Width());
+
+	float ReciprocalW = Plane_Equation_At(&Setup->ReciprocalW, Setup, X0, y);
+	float ReciprocalWStepX = Setup->ReciprocalW.StepX;
+	float DepthBias = Get_Depth_Bias(); // See DEPTH_GENERATIONS
+	float DepthScale = Get_Depth_Scale();
+
+	if (Setup->TextureBuffer == NULL)
+	{
+		for (int x = X0; x <= X1; x++)
+		{
+			ColorBuffer[RowIndex + Pixel_Column_Offset(x)] = Setup->Color;
+			Store_Depth(ZBuffer, RowIndex + Pixel_Column_Offset(x), Make_Depth(ReciprocalW, DepthBias, DepthScale, DepthFormat), DepthFormat);
+			ReciprocalW += ReciprocalWStepX;
+		}
+		return;
+	}
+
+	color_t* TextureBuffer = Setup->TextureBuffer;
+	int TextureWidth = Setup->TextureWidth;
+	int TextureHeight = Setup->TextureHeight;
+	float UOverW = Plane_Equation_At(&Setup->UOverW, Setup, X0, y);
+	float VOverW = Plane_Equation_At(&Setup->VOverW, Setup, X0, y);
+	float UOverWStepX = Setup->UOverW.StepX;
+	float VOverWStepX = Setup->VOverW.StepX;
+
+	int SpanLength = Get_Perspective_Span_Length();
+	if (SpanLength != PERSPECTIVE_SPAN_EXACT)
+	{
+		// Every pixel of a visible span is inside the triangle, so the sub-spans simply end every SpanLength pixels or at X1
+		float SpanU, SpanV;
+		Perspective_Texel_Coords(Setup, ReciprocalW, UOverW, VOverW, &SpanU, &SpanV);
+
+		for (int SpanX0 = X0; SpanX0 <= X1; SpanX0 += SpanLength)
+		{
+			int SpanX1 = SpanX0 + SpanLength;
+			if (SpanX1 > X1)
+			{
+				SpanX1 = X1;
+			}
+
+			float EndU, EndV;
+			Perspective_Texel_Coords(Setup, Plane_Equation_At(&Setup->ReciprocalW, Setup, SpanX1, y),
+				Plane_Equation_At(&Setup->UOverW, Setup, SpanX1, y), Plane_Equation_At(&Setup->VOverW, Setup, SpanX1, y), &EndU, &EndV);
+
+			float InvPixels = (SpanX1 > SpanX0) ? 1.0f / (float)(SpanX1 - SpanX0) : 0.0f;
+			float StepU = (EndU - SpanU) * InvPixels;
+			float StepV = (EndV - SpanV) * InvPixels;
+
+			// The end pixel is the start of the next sub-span, so it's shaded there (unless it's X1)
+			int LastX = (SpanX1 == X1) ? X1 : SpanX1 - 1;
+			for (int x = SpanX0; x <= LastX; x++)
+			{
+				int TextureX = abs((int)(SpanU + (StepU * (x - SpanX0)))) % TextureWidth;
+				int TextureY = abs((int)(SpanV + (StepV * (x - SpanX0)))) % TextureHeight;
+
+				ColorBuffer[RowIndex + Pixel_Column_Offset(x)] = TextureBuffer[(TextureWidth * TextureY) + TextureX];
+				Store_Depth(ZBuffer, RowIndex + Pixel_Column_Offset(x), Make_Depth(ReciprocalW, DepthBias, DepthScale, DepthFormat), DepthFormat);
+				ReciprocalW += ReciprocalWStepX;
+			}
+
+			if (SpanX1 == X1)
+			{
+				break;
+			}
+			SpanU = EndU;
+			SpanV = EndV;
+		}
+		return;
+	}
+
+	for (int x = X0; x <= X1; x++)
+	{
+		// Same texture lookup as the textured pixel loop: undo the perspective with the interpolated 1/W
+		float W = Interpolation_Divide(1.0f, ReciprocalW);
+		int TextureX = abs((int)(UOverW * W * TextureWidth)) % TextureWidth;
+		int TextureY = abs((int)(VOverW * W * TextureHeight)) % TextureHeight;
+
+		ColorBuffer[RowIndex + Pixel_Column_Offset(x)] = TextureBuffer[(TextureWidth * TextureY) + TextureX];
+		Store_Depth(ZBuffer, RowIndex + Pixel_Column_Offset(x), Make_Depth(ReciprocalW, DepthBias, DepthScale, DepthFormat), DepthFormat);
+
+		ReciprocalW += ReciprocalWStepX;
+		UOverW += UOverWStepX;
+		VOverW += VOverWStepX;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Resolve and shade the scanlines of one thread (thread K takes the rows K, K + N, K + 2N...)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void Render_Thread_Scanlines(int ThreadIndex, int NumThreads)
+{
+	span_t** Lists = ThreadSpans[ThreadIndex];
+	int ShadedPixels = 0;
+
+	for (int y = ThreadIndex; y < NumRows; y += NumThreads)
+	{
+		int* Bin = RowBins[y];
+		int NumBinned = Array_Length(Bin);
+		int Current = 0;
+
+		Array_Clear(Lists[Current]);
+
+		// Same order the triangles were submitted, so the ties are solved like the depth buffer does
+		for (int idx = 0; idx < NumBinned; idx++)
+		{
+			int X0, X1;
+			if (Get_Triangle_Span(Get_Triangle_Setup(Bin[idx]), y, &X0, &X1))
+			{
+				Lists[1 - Current] = Insert_Span(Lists[Current], Lists[1 - Current], X0, X1, Bin[idx], y);
+				Current = 1 - Current;
+			}
+		}
+
+		span_t* Spans = Lists[Current];
+		int NumSpans = Array_Length(Spans);
+		for (int idx = 0; idx < NumSpans; idx++)
+		{
+			Shade_Span(Get_Triangle_Setup(Spans[idx].Setup), Spans[idx].X0, Spans[idx].X1, y);
+			ShadedPixels += Spans[idx].X1 - Spans[idx].X0 + 1;
+		}
+	}
+
+	Add_Shaded_Pixels(ShadedPixels);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Initialize_Span_Buffer(void)
+{
+	NumRows = Get_Window_Height();
+
+	RowBins = (int**)calloc(NumRows, sizeof(int*));
+	if (!RowBins)
+	{
+		fprintf(stderr, "Error allocating the scanline bins.\n");
+		return false;
+	}
+
+	return true;
+}
+
+void Destroy_Span_Buffer(void)
+{
+	if (RowBins)
+	{
+		for (int idx = 0; idx < NumRows; idx++)
+		{
+			Array_Free(RowBins[idx]);
+		}
+		free(RowBins);
+		RowBins = NULL;
+	}
+
+	for (int idx = 0; idx < MAX_RASTER_THREADS; idx++)
+	{
+		Array_Free(ThreadSpans[idx][0]);
+		Array_Free(ThreadSpans[idx][1]);
+		ThreadSpans[idx][0] = NULL;
+		ThreadSpans[idx][1] = NULL;
+	}
+}
+
+void Render_Span_Buffer(void)
+{
+	NumBinned = 0;
+	for (int idx = 0; idx < NumRows; idx++)
+	{
+		Array_Clear(RowBins[idx]);
+	}
+
+	int NumSetups = Get_Num_Triangle_Setups();
+	for (int SetupIndex = 0; SetupIndex < NumSetups; SetupIndex++)
+	{
+		const triangle_setup_t* Setup = Get_Triangle_Setup(SetupIndex);
+		if (Is_Triangle_Setup_Empty(Setup))
+		{
+			continue;
+		}
+
+		// The bounding box is already clamped to the screen, so these are always valid rows
+		NumBinned++;
+		for (int y = Setup->MinY; y <= Setup->MaxY; y++)
+		{
+			Array_Push(RowBins[y], SetupIndex);
+		}
+	}
+
+	if (NumBinned == 0)
+	{
+		return;
+	}
+
+	Run_Raster_Job(Render_Thread_Scanlines);
+}
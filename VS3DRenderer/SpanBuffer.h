@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef SPAN_BUFFER_H
+#define SPAN_BUFFER_H
+
+#include <stdbool.h>
+#include "Triangle.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Span buffer (S-buffer) renderer: visibility is solved per span of pixels instead of per pixel
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Every scanline keeps a list of spans sorted by X that never overlap, each one saying which triangle is visible
+	along it. The spans of the triangles that cross the scanline are inserted in the same order they were submitted,
+	and each insertion only compares depths where the new span overlaps the spans already in the list:
+
+	list:   [---- A ----]       [-- B --]
+	new:          [========== C ==========]       (C closer than A on the right of the crossing, always behind B)
+	result: [-- A --][C][- C -][-- B --][C]
+
+	1/W changes linearly along the scanline for both triangles, so the point where one gets in front of the other
+	is found with one division, never by testing the pixels. Once all the spans are inserted, each pixel is shaded
+	exactly once, and there's no depth test at all (the depth buffer is still written, once per pixel, so it keeps
+	being valid for whatever comes after).
+
+	The span of a triangle comes from its fixed point edge functions, so it covers exactly the pixels the edge
+	function rasterizer would cover. Scanlines are independent, so they're split among the raster threads.
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Create the per-scanline bins. Call it after the window was created (it uses its size)
+bool Initialize_Span_Buffer(void);
+
+// Free the bins and the span lists
+void Destroy_Span_Buffer(void);
+
+// Resolve the visible spans of every scanline from the setup records of the filled or textured triangles
+// (see TriangleSetups.h), and shade them
+void Render_Span_Buffer(void);
+
+#endif // !SPAN_BUFFER_H
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <string.h>
+#include <SDL.h>
+#include "Display.h"
+#include "Clipping.h"
+#include "Triangle.h"
+#include "Stats.h"
+
+static bool bShowStats = false;
+
+static Uint64 RasterStartCounter = 0; // Performance counter value when the rasterization started
+static Uint64 RasterAccumulatedCounter = 0; // Sum of the rasterization times of the accumulated frames
+static Uint64 SetupStartCounter = 0; // Performance counter value when the setup stage started
+static Uint64 SetupAccumulatedCounter = 0; // Sum of the setup stage times of the accumulated frames
+static int AccumulatedFrames = 0;
+
+static SDL_atomic_t FrameShadedPixels; // Pixels shaded during the current frame, by all the threads
+static Uint64 AccumulatedShadedPixels = 0; // Sum of the shaded pixels of the accumulated frames
+static Uint64 AccumulatedVisiblePixels = 0; // Sum of the pixels covered by a triangle at the end of the accumulated frames
+static Uint64 AccumulatedClipClasses[NUM_TRIANGLE_CLIP_CLASSES]; // Triangles accepted, rejected and clipped in the accumulated frames
+static Uint64 AccumulatedSizeClasses[NUM_TRIANGLE_SIZE_CLASSES]; // Projected triangles culled, small and regular in the accumulated frames
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Count the pixels of the depth buffer that some triangle has written this frame (they're closer than the depth bias,
+// the cleared ones are at 1.0 and the ones left by older depth generations are farther than the bias too)
+// With the integer formats, they're the ones below the clear value (the max of the format)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int Count_Visible_Pixels(void)
+{
+	void* ZBuffer = Get_ZBuffer();
+	int NumPixels = Get_Buffer_Width() * Get_Buffer_Height(); // The padding of the tiles is never drawn, it stays cleared
+	float DepthBias = Get_Depth_Bias();
+	int VisiblePixels = 0;
+
+	for (int idx = 0; idx < NumPixels; idx++)
+	{
+		switch (Get_Depth_Format())
+		{
+		case DEPTH_FORMAT_UNORM16:
+			VisiblePixels += (((uint16_t*)ZBuffer)[idx] < DEPTH_UNORM16_MAX) ? 1 : 0;
+			break;
+		case DEPTH_FORMAT_UNORM24:
+			VisiblePixels += (((uint32_t*)ZBuffer)[idx] < DEPTH_UNORM24_MAX) ? 1 : 0;
+			break;
+		default:
+			VisiblePixels += (((float*)ZBuffer)[idx] < DepthBias) ? 1 : 0;
+			break;
+		}
+	}
+	return VisiblePixels;
+}
+
+void Set_Show_Stats(bool bShow)
+{
+	bShowStats = bShow;
+	RasterAccumulatedCounter = 0;
+	SetupAccumulatedCounter = 0;
+	AccumulatedShadedPixels = 0;
+	AccumulatedVisiblePixels = 0;
+	memset(AccumulatedClipClasses, 0, sizeof(AccumulatedClipClasses));
+	memset(AccumulatedSizeClasses, 0, sizeof(AccumulatedSizeClasses));
+	AccumulatedFrames = 0;
+}
+
+bool Is_Show_Stats(void)
+{
+	return bShowStats;
+}
+
+void Begin_Raster_Timer(void)
+{
+	SDL_AtomicSet(&FrameShadedPixels, 0);
+	RasterStartCounter = SDL_GetPerformanceCounter();
+}
+
+void End_Raster_Timer(void)
+{
+	RasterAccumulatedCounter += SDL_GetPerformanceCounter() - RasterStartCounter;
+}
+
+void Begin_Setup_Timer(void)
+{
+	SetupStartCounter = SDL_GetPerformanceCounter();
+}
+
+void End_Setup_Timer(void)
+{
+	SetupAccumulatedCounter += SDL_GetPerformanceCounter() - SetupStartCounter;
+}
+
+void Add_Shaded_Pixels(int Count)
+{
+	if (Count > 0)
+	{
+		SDL_AtomicAdd(&FrameShadedPixels, Count);
+	}
+}
+
+void Add_Triangle_Clip_Class(int TriangleClass)
+{
+	AccumulatedClipClasses[TriangleClass]++;
+}
+
+void Add_Triangle_Size_Class(int SizeClass)
+{
+	AccumulatedSizeClasses[SizeClass]++;
+}
+
+void Report_Frame_Stats(const char* RasterModeName, const char* ParallelModeName)
+{
+	if (!bShowStats)
+	{
+		return;
+	}
+
+	AccumulatedShadedPixels += SDL_AtomicGet(&FrameShadedPixels);
+	AccumulatedVisiblePixels += Count_Visible_Pixels();
+	AccumulatedFrames++;
+	if (AccumulatedFrames < FPS)
+	{
+		return;
+	}
+
+	// Convert the performance counter ticks to miliseconds and average them by the number of frames
+	double RasterMiliseconds = (RasterAccumulatedCounter * 1000.0) / (double)SDL_GetPerformanceFrequency();
+	printf("Raster (%s, %s, %s renderers, %s depth): %.3f ms/frame\n", RasterModeName, ParallelModeName,
+		Is_Specialized_Renderers() ? "specialized" : "generic", Get_Depth_Format_Name(), RasterMiliseconds / AccumulatedFrames);
+
+	// The setup records are built before the raster timer starts, so their time is shown apart
+	if (SetupAccumulatedCounter > 0)
+	{
+		double SetupMiliseconds = (SetupAccumulatedCounter * 1000.0) / (double)SDL_GetPerformanceFrequency();
+		printf("Triangle setup records: %.3f ms/frame\n", SetupMiliseconds / AccumulatedFrames);
+	}
+
+	printf("Triangles: %llu/frame accepted without clipping, %llu rejected, %llu clipped\n",
+		(unsigned long long)(AccumulatedClipClasses[TRIANGLE_ACCEPTED] / AccumulatedFrames),
+		(unsigned long long)(AccumulatedClipClasses[TRIANGLE_REJECTED] / AccumulatedFrames),
+		(unsigned long long)(AccumulatedClipClasses[TRIANGLE_CLIPPED] / AccumulatedFrames));
+
+	// Only the edge function rasterizer counts the shaded pixels
+	if (Is_Raster_Edge_Function())
+	{
+		Uint64 ShadedPixels = AccumulatedShadedPixels / AccumulatedFrames;
+		Uint64 VisiblePixels = AccumulatedVisiblePixels / AccumulatedFrames;
+		Uint64 OverdrawnPixels = (ShadedPixels > VisiblePixels) ? ShadedPixels - VisiblePixels : 0;
+		printf("Pixels (%s): %llu shaded/frame, %llu visible, %llu shaded and then hidden\n",
+			Is_Front_To_Back() ? "front to back" : "unsorted",
+			(unsigned long long)ShadedPixels, (unsigned long long)VisiblePixels, (unsigned long long)OverdrawnPixels);
+
+		// Only counted when the small triangles can be culled (no wireframe or vertices drawn over them)
+		printf("Triangle sizes: %llu/frame culled without pixel centers, %llu culled without coverage, %llu small, %llu regular\n",
+			(unsigned long long)(AccumulatedSizeClasses[TRIANGLE_SIZE_NO_PIXEL_CENTER] / AccumulatedFrames),
+			(unsigned long long)(AccumulatedSizeClasses[TRIANGLE_SIZE_NO_COVERAGE] / AccumulatedFrames),
+			(unsigned long long)(AccumulatedSizeClasses[TRIANGLE_SIZE_SMALL] / AccumulatedFrames),
+			(unsigned long long)(AccumulatedSizeClasses[TRIANGLE_SIZE_REGULAR] / AccumulatedFrames));
+	}
+
+	RasterAccumulatedCounter = 0;
+	SetupAccumulatedCounter = 0;
+	AccumulatedShadedPixels = 0;
+	AccumulatedVisiblePixels = 0;
+	memset(AccumulatedClipClasses, 0, sizeof(AccumulatedClipClasses));
+	memset(AccumulatedSizeClasses, 0, sizeof(AccumulatedSizeClasses));
+	AccumulatedFrames = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Frame statistics, used to compare the different rasterization paths
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Enable or disable printing the statistics to the console (once per second)
+void Set_Show_Stats(bool bShow);
+bool Is_Show_Stats(void);
+
+// Measure how long the rasterization of all the triangles takes each frame
+void Begin_Raster_Timer(void);
+void End_Raster_Timer(void);
+
+// Measure how long the setup stage takes each frame (when the raster path uses setup records)
+void Begin_Setup_Timer(void);
+void End_Setup_Timer(void);
+
+// Count the pixels that got a new color this frame (any thread can call it)
+// Together with the pixels that end up covered, it shows how many were shaded and then hidden by a closer triangle
+void Add_Shaded_Pixels(int Count);
+
+// Count one triangle of the geometry stage by how the clipping classified it (TRIANGLE_ACCEPTED, ...)
+void Add_Triangle_Clip_Class(int TriangleClass);
+
+// Count one projected triangle by its size class (TRIANGLE_SIZE_NO_PIXEL_CENTER, ...)
+void Add_Triangle_Size_Class(int SizeClass);
+
+// Accumulate the current frame and print the averages every FPS frames
+void Report_Frame_Stats(const char* RasterModeName, const char* ParallelModeName);
+
+#endif // !STATS_H
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <SDL.h>
+#include "Array.h"
+#include "Display.h"
+#include "RasterThreads.h"
+#include "Stats.h"
+#include "Tiles.h"
+#include "TriangleSetups.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Declare the tiles and their bins
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static int TilesX = 0; // Number of tile columns and rows covering the screen
+static int TilesY = 0;
+
+static int** TileBins = NULL; // One dynamic array per tile, with the indices of the setup records of its triangles
+static int NumBinned = 0; // Setup records binned this frame
+
+static SDL_atomic_t NextTile; // Index of the next tile that nobody has taken yet
+static bool bBinnedTextured = false; // Whether any textured triangle was binned this frame
+static bool bTilesDepthPrepass = false; // Rasterize each tile twice: first the depth, then the color of the visible pixels
+
+// The tile buffers of each raster thread (indexed by ThreadIndex), TILE_SIZE x TILE_SIZE colors and depths each
+static render_target_t* TileTargets = NULL;
+static int NumTileTargets = 0;
+static bool bUseTileBuffers = false; // This frame rasterizes into the tile buffers (Is_Tile_Buffers)
+static bool bResolveTileDepth = false; // And copies their depths back to the ZBuffer too
+static color_t TileClearColor = 0;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Take tiles until there are no more left, and rasterize their triangles
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void Rasterize_Pending_Tiles(int ThreadIndex, int NumThreads)
+{
+	// Any thread can take any tile, the thread index only picks its own tile buffers
+	(void)NumThreads;
+	render_target_t* TileTarget = &TileTargets[ThreadIndex];
+	const render_target_t* Target = bUseTileBuffers ? TileTarget : Get_Screen_Target();
+
+	int NumTiles = TilesX * TilesY;
+	int MaxX = Get_Window_Width() - 1;
+	int MaxY = Get_Window_Height() - 1;
+	int ShadedPixels = 0;
+
+	// The atomic add gives each tile to one thread only
+	for (int Tile = SDL_AtomicAdd(&NextTile, 1); Tile < NumTiles; Tile = SDL_AtomicAdd(&NextTile, 1))
+	{
+		int* Bin = TileBins[Tile];
+		int NumTileTriangles = Array_Length(Bin);
+
+		int X0 = (Tile % TilesX) * TILE_SIZE;
+		int Y0 = (Tile / TilesX) * TILE_SIZE;
+		int X1 = (X0 + TILE_SIZE - 1 < MaxX) ? X0 + TILE_SIZE - 1 : MaxX;
+		int Y1 = (Y0 + TILE_SIZE - 1 < MaxY) ? Y0 + TILE_SIZE - 1 : MaxY;
+
+		if (bUseTileBuffers)
+		{
+			// The buffers of the thread move to this tile, and start cleared like the screen would
+			TileTarget->OriginX = X0;
+			TileTarget->OriginY = Y0;
+			Clear_Render_Target(TileTarget, TILE_SIZE * TILE_SIZE, X1, Y1, TileClearColor);
+		}
+
+		if (bTilesDepthPrepass)
+		{
+			// The tile belongs to this thread only, so the second pass always sees the final depth of the first one
+			for (int idx = 0; idx < NumTileTriangles; idx++)
+			{
+				ShadedPixels += Rasterize_Triangle_Rect(Get_Triangle_Setup(Bin[idx]), Target, RASTER_PASS_DEPTH_ONLY, X0, Y0, X1, Y1);
+			}
+			for (int idx = 0; idx < NumTileTriangles; idx++)
+			{
+				ShadedPixels += Rasterize_Triangle_Rect(Get_Triangle_Setup(Bin[idx]), Target, RASTER_PASS_EQUAL_DEPTH, X0, Y0, X1, Y1);
+			}
+		}
+		else
+		{
+			for (int idx = 0; idx < NumTileTriangles; idx++)
+			{
+				ShadedPixels += Rasterize_Triangle_Rect(Get_Triangle_Setup(Bin[idx]), Target, RASTER_PASS_COLOR, X0, Y0, X1, Y1);
+			}
+		}
+
+		// The finished tile goes to the screen in one pass, and its depths only when somebody reads them afterwards
+		if (bUseTileBuffers)
+		{
+			Resolve_Render_Target(TileTarget, X1, Y1, bResolveTileDepth);
+		}
+	}
+
+	// Only one atomic add per thread
+	Add_Shaded_Pixels(ShadedPixels);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Initialize_Tiles(void)
+{
+	TilesX = (Get_Window_Width() + TILE_SIZE - 1) / TILE_SIZE;
+	TilesY = (Get_Window_Height() + TILE_SIZE - 1) / TILE_SIZE;
+
+	TileBins = (int**)calloc(TilesX * TilesY, sizeof(int*));
+	if (!TileBins)
+	{
+		fprintf(stderr, "Error allocating the tile bins.\n");
+		return false;
+	}
+
+	// The depths of the tiles take 32 bits, enough for any format of the depth buffer
+	NumTileTargets = Get_Raster_Thread_Count();
+	TileTargets = (render_target_t*)calloc(NumTileTargets, sizeof(render_target_t));
+	if (!TileTargets)
+	{
+		fprintf(stderr, "Error allocating the tile buffers.\n");
+		return false;
+	}
+	for (int idx = 0; idx < NumTileTargets; idx++)
+	{
+		TileTargets[idx].ColorBuffer = (color_t*)malloc(sizeof(color_t) * TILE_SIZE * TILE_SIZE);
+		TileTargets[idx].ZBuffer = malloc(sizeof(uint32_t) * TILE_SIZE * TILE_SIZE);
+		TileTargets[idx].Width = TILE_SIZE;
+		if (!TileTargets[idx].ColorBuffer || !TileTargets[idx].ZBuffer)
+		{
+			fprintf(stderr, "Error allocating the tile buffers.\n");
+			return false;
+		}
+	}
+
+	SDL_AtomicSet(&NextTile, 0);
+	return true;
+}
+
+void Destroy_Tiles(void)
+{
+	if (TileBins)
+	{
+		for (int idx = 0; idx < TilesX * TilesY; idx++)
+		{
+			Array_Free(TileBins[idx]);
+		}
+		free(TileBins);
+		TileBins = NULL;
+	}
+
+	if (TileTargets)
+	{
+		for (int idx = 0; idx < NumTileTargets; idx++)
+		{
+			free(TileTargets[idx].ColorBuffer);
+			free(TileTargets[idx].ZBuffer);
+		}
+		free(TileTargets);
+		TileTargets = NULL;
+	}
+}
+
+void Begin_Tile_Binning(void)
+{
+	NumBinned = 0;
+	bBinnedTextured = false;
+	for (int idx = 0; idx < TilesX * TilesY; idx++)
+	{
+		Array_Clear(TileBins[idx]);
+	}
+}
+
+void Bin_Triangle_Setup(int SetupIndex)
+{
+	const triangle_setup_t* Setup = Get_Triangle_Setup(SetupIndex);
+	if (!Setup || Is_Triangle_Setup_Empty(Setup))
+	{
+		return;
+	}
+
+	// Filled triangles don't have a texture
+	bBinnedTextured = bBinnedTextured || (Setup->TextureBuffer != NULL);
+	NumBinned++;
+
+	// The bounding box is already clamped to the screen, so these are always valid tiles
+	int FirstTileX = Setup->MinX / TILE_SIZE;
+	int FirstTileY = Setup->MinY / TILE_SIZE;
+	int LastTileX = Setup->MaxX / TILE_SIZE;
+	int LastTileY = Setup->MaxY / TILE_SIZE;
+
+	for (int TileY = FirstTileY; TileY <= LastTileY; TileY++)
+	{
+		for (int TileX = FirstTileX; TileX <= LastTileX; TileX++)
+		{
+			Array_Push(TileBins[(TileY * TilesX) + TileX], SetupIndex);
+		}
+	}
+}
+
+void Rasterize_Tiles(color_t ClearColor)
+{
+	// With the tile buffers, the empty tiles still have to write their cleared pixels
+	bUseTileBuffers = Is_Tile_Buffers();
+	if (NumBinned == 0 && !bUseTileBuffers)
+	{
+		return;
+	}
+
+	// The frame statistics count the visible pixels in the ZBuffer
+	bResolveTileDepth = Is_Show_Stats();
+	TileClearColor = ClearColor;
+	bTilesDepthPrepass = Is_Depth_Prepass() && bBinnedTextured;
+	SDL_AtomicSet(&NextTile, 0);
+	Run_Raster_Job(Rasterize_Pending_Tiles);
+}
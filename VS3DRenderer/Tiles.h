@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef TILES_H
+#define TILES_H
+
+#include <stdbool.h>
+#include "Triangle.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Multi-threaded tile rasterization
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	The screen is split in tiles of TILE_SIZE x TILE_SIZE pixels. Each frame the setup records of the triangles are
+	binned: their index is added to every tile their bounding box touches. Then the raster threads take the
+	tiles one by one and rasterizes the triangles binned into them, clipped to the tile.
+
+	+------+------+------+
+	|  0   |  1 /\|  2   |     The triangle is binned into tiles 1, 2, 4 and 5
+	|      |  /  |\      |     Each thread only writes the color/depth of the tile it's working on,
+	+------+/----|-\-----+     and no 2 threads ever work on the same tile, so no locks are needed
+	|  3  /|  4  |  \ 5  |
+	+------+------+------+
+
+	Inside a tile, the triangles are rasterized in the same order they were binned, so the depth test gives the
+	same result as rasterizing them one by one.
+
+	With the tile buffers (Is_Tile_Buffers), each thread rasterizes the tile into its own TILE_SIZE x TILE_SIZE
+	color and depth buffers (16 KB each), which stay in its L1/L2 cache while all the triangles of the tile go
+	over them, instead of going to the screen buffers for every pixel:
+
+	  clear tile buffers -> rasterize the bin -> copy the colors to the screen (non-temporal stores)
+
+	The tiles cover the whole screen, so the color buffer isn't cleared beforehand (the empty tiles write their
+	cleared colors too). The depths stay in the tile and are thrown away, unless the frame statistics need them.
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Size of the (square) tiles, in pixels. Multiple of RASTER_BLOCK_SIZE, so the blocks never cross a tile
+#define TILE_SIZE 64
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Create the tile bins. Call it after the window was created (it uses its size)
+bool Initialize_Tiles(void);
+
+// Free the bins
+void Destroy_Tiles(void);
+
+// Empty the bins, before binning the triangles of a new frame
+void Begin_Tile_Binning(void);
+
+// Add the setup record with that index (see TriangleSetups.h) to the bins of every tile its bounding box touches
+void Bin_Triangle_Setup(int SetupIndex);
+
+// Rasterize all the binned triangles using every thread, and wait until they're done
+// With the tile buffers every pixel of the screen gets written, the ones without triangles with ClearColor
+void Rasterize_Tiles(color_t ClearColor);
+
+#endif // !TILES_H
@@ -1,6 +1,10 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
 #include "Swap.h"
+#include "Stats.h"
 #include "Triangle.h"
+#include "TriangleSIMD.h"
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Return the barycentric weights (alpha, beta, gamma) for point P inside a triangle ABC
@@ -32,10 +36,10 @@ vec3_t Barycentric_Weights(vec2_t A, vec2_t B, vec2_t C, vec2_t P)
 	float AreaTriABC = (SubBA.x * SubCA.y) - (SubBA.y * SubCA.x);
 
 	// Weight alpha is the area of the sub-triangle PBC divided by the area of the full triangle ABC
-	float Alpha = ( (SubBP.x * SubCP.y) - (SubBP.y * SubCP.x) ) / AreaTriABC;
+	float Alpha = Interpolation_Divide((SubBP.x * SubCP.y) - (SubBP.y * SubCP.x), AreaTriABC);
 
 	// Weight beta is the area of the sub-triangle PCA divided by the area of the full triangle ABC
-	float Beta = ((SubCP.x * SubAP.y) - (SubCP.y * SubAP.x)) / AreaTriABC;
+	float Beta = Interpolation_Divide((SubCP.x * SubAP.y) - (SubCP.y * SubAP.x), AreaTriABC);
 
 	//printf("PB.X: %f, CB.X: %f, PB.Y: %f, CB.Y: %F \n", SubPB.x, SubCB.x, SubPB.y, SubCB.y);
 
@@ -49,6 +53,55 @@ vec3_t Barycentric_Weights(vec2_t A, vec2_t B, vec2_t C, vec2_t P)
 	return Weights;
 }
 
+#if defined(INTERPOLATION_FAST_RECIPROCAL)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Accuracy of the fast reciprocal against the exact division (see FAST_RECIPROCAL)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Report_Fast_Reciprocal_Accuracy(void)
+{
+	// The approximation only depends on the mantissa (the exponent just scales it), so the 2^23 floats of [1,2)
+	// cover every case except the denormals and the infinities, that never get here
+	double MaxRelativeError = 0.0;
+	int MaxUlps = 0;
+	int NumExact = 0;
+	const int NumMantissas = 1 << 23;
+	for (int Mantissa = 0; Mantissa < NumMantissas; Mantissa++)
+	{
+		union { float Float; int32_t Bits; } X, Exact, Fast;
+		X.Bits = 0x3F800000 | Mantissa;
+		Exact.Float = 1.0f / X.Float;
+		Fast.Float = Fast_Reciprocal(X.Float);
+
+		double RelativeError = fabs(((double)Fast.Float - (double)Exact.Float) / (double)Exact.Float);
+		MaxRelativeError = SDL_max(MaxRelativeError, RelativeError);
+		MaxUlps = SDL_max(MaxUlps, abs(Fast.Bits - Exact.Bits));
+		NumExact += (Fast.Bits == Exact.Bits);
+	}
+
+	// What the pixels see: texel columns of a 1024 texel wide texture, for U in [0,1] and W from the near to the far plane
+	const int TextureSize = 1024;
+	const int NumSamples = 1024;
+	int NumTexelsChanged = 0;
+	for (int WSample = 0; WSample < NumSamples; WSample++)
+	{
+		float ReciprocalW = 1.0f / (0.1f + (99.9f * WSample / (NumSamples - 1)));
+		for (int USample = 0; USample < NumSamples; USample++)
+		{
+			float UOverW = ((float)USample / (NumSamples - 1)) * ReciprocalW;
+			int ExactTexel = (int)(UOverW * (1.0f / ReciprocalW) * TextureSize);
+			int FastTexel = (int)(UOverW * Fast_Reciprocal(ReciprocalW) * TextureSize);
+			NumTexelsChanged += (ExactTexel != FastTexel);
+		}
+	}
+
+	printf("Fast reciprocal: max relative error %.3g (%d ulps), %.2f%% of the results equal to the division\n",
+		MaxRelativeError, MaxUlps, (100.0 * NumExact) / NumMantissas);
+	printf("Fast reciprocal: %d of %d texel columns of a %d texel texture changed (U from 0 to 1, W from 0.1 to 100)\n",
+		NumTexelsChanged, NumSamples * NumSamples, TextureSize);
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Draw a pixel witth solid color at position (X,Y) of a triangle using interpolation
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -77,9 +130,9 @@ void Draw_Triangle_Pixel(
 	float Simplified2 = Gamma * VertexA.w * VertexB.w;
 	float SimplifiedAddition = Simplified0 + Simplified1 + Simplified2;
 	float WMultiplication = VertexA.w * VertexB.w * VertexC.w;
-	float ReciprocalW = SimplifiedAddition / WMultiplication;
+	float ReciprocalW = Interpolation_Divide(SimplifiedAddition, WMultiplication);
 	// Adjust the reciprocal W so the pixels that are closer to the camera have smaller values
-	ReciprocalW = 1.0 - ReciprocalW;
+	ReciprocalW = Get_Depth_Bias() - ReciprocalW;
 
 	// Only draw the current pixel ih its depth value is less than what was already previously stored in the ZBuffer
 	// Basically, if the current pixel that is going to be drawn is in front of was already there
@@ -298,7 +351,7 @@ void Draw_Texel(
 	float Simplified1 = Beta * VertexA.w * VertexC.w;
 	float Simplified2 = Gamma * VertexA.w * VertexB.w;
 	float SimplifiedAddition = Simplified0 + Simplified1 + Simplified2;
-	float SimplifiedDivision = 1 / SimplifiedAddition;
+	float SimplifiedDivision = Interpolation_Divide(1.0f, SimplifiedAddition);
 	InterpolatedU = ( (AUV.u * Simplified0) + (BUV.u*Simplified1) + (CUV.u*Simplified2) ) * SimplifiedDivision;
 	InterpolatedV = ((AUV.v * Simplified0) + (BUV.v*Simplified1) + (CUV.v*Simplified2)) * SimplifiedDivision;
 
@@ -315,9 +368,9 @@ void Draw_Texel(
 	// Only draw the current pixel ih its depth value is less than what was already previously stored in the ZBuffer
 	// Basically, if the current pixel that is going to be drawn is in front of was already there
 	float WMultiplication = VertexA.w * VertexB.w * VertexC.w;
-	float ReciprocalW = SimplifiedAddition / WMultiplication;
+	float ReciprocalW = Interpolation_Divide(SimplifiedAddition, WMultiplication);
 	// Adjust the reciprocal W so the pixels that are closer to the camera have smaller values
-	ReciprocalW = 1.0 - ReciprocalW;	
+	ReciprocalW = Get_Depth_Bias() - ReciprocalW;	
 	// Make sure the current pixel index is inside the screen! (that's achived with the % operation)
 	//int PixelIndex = ((Get_Window_Width() * y) + x)%(Get_Window_Width() * Get_Window_Height()); // (windowWith * current row) + current column
 	//if ( ReciprocalW < ZBuffer[PixelIndex])
@@ -337,6 +390,87 @@ void Draw_Texel(
 	}	
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Draw the texels of a scanline from XStart to XEnd (not included) with perspective span subdivision
+// U, V and 1/W are perspective correct only every SpanLength pixels, and interpolated linearly in between
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Same "Simplified" barycentric interpolation as Draw_Texel, for a single point of the scanline
+static void Interpolate_Texel_At(
+	int x, int y,
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	tex2_t AUV, tex2_t BUV, tex2_t CUV,
+	float* U, float* V, float* ReciprocalW
+	)
+{
+	vec2_t CurrentPixel = { x, y };
+	vec3_t BarycentricWeights = Barycentric_Weights(Vec4_To_Vec2(VertexA), Vec4_To_Vec2(VertexB), Vec4_To_Vec2(VertexC), CurrentPixel);
+
+	float Simplified0 = BarycentricWeights.x * VertexB.w * VertexC.w;
+	float Simplified1 = BarycentricWeights.y * VertexA.w * VertexC.w;
+	float Simplified2 = BarycentricWeights.z * VertexA.w * VertexB.w;
+	float SimplifiedAddition = Simplified0 + Simplified1 + Simplified2;
+	float SimplifiedDivision = Interpolation_Divide(1.0f, SimplifiedAddition);
+	*U = ((AUV.u * Simplified0) + (BUV.u * Simplified1) + (CUV.u * Simplified2)) * SimplifiedDivision;
+	*V = ((AUV.v * Simplified0) + (BUV.v * Simplified1) + (CUV.v * Simplified2)) * SimplifiedDivision;
+	*ReciprocalW = Interpolation_Divide(SimplifiedAddition, VertexA.w * VertexB.w * VertexC.w);
+}
+
+static void Draw_Texel_Span(
+	int XStart, int XEnd, int y,
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	tex2_t AUV, tex2_t BUV, tex2_t CUV,
+	upng_t* Texture, int SpanLength
+	)
+{
+	int TextureWidth = upng_get_width(Texture);
+	int TextureHeight = upng_get_height(Texture);
+	color_t* TextureBuffer = (color_t*)upng_get_buffer(Texture);
+
+	float DepthBias = Get_Depth_Bias(); // See DEPTH_GENERATIONS
+
+	float SpanU, SpanV, SpanReciprocalW;
+	Interpolate_Texel_At(XStart, y, VertexA, VertexB, VertexC, AUV, BUV, CUV, &SpanU, &SpanV, &SpanReciprocalW);
+
+	for (int SpanX0 = XStart; SpanX0 < XEnd; SpanX0 += SpanLength)
+	{
+		// The last sub-span ends at the last pixel of the scanline
+		int SpanX1 = SDL_min(SpanX0 + SpanLength, XEnd - 1);
+
+		float EndU, EndV, EndReciprocalW;
+		Interpolate_Texel_At(SpanX1, y, VertexA, VertexB, VertexC, AUV, BUV, CUV, &EndU, &EndV, &EndReciprocalW);
+
+		float InvPixels = (SpanX1 > SpanX0) ? 1.0f / (float)(SpanX1 - SpanX0) : 0.0f;
+		float StepU = (EndU - SpanU) * InvPixels;
+		float StepV = (EndV - SpanV) * InvPixels;
+		float StepReciprocalW = (EndReciprocalW - SpanReciprocalW) * InvPixels;
+
+		// The end pixel is the start of the next sub-span, so it's drawn there (unless it's the last one)
+		int LastX = (SpanX1 == XEnd - 1) ? SpanX1 : SpanX1 - 1;
+		for (int x = SpanX0; x <= LastX; x++)
+		{
+			// Same depth test and texture lookup as Draw_Texel
+			float Depth = DepthBias - (SpanReciprocalW + (StepReciprocalW * (x - SpanX0)));
+			if (Depth < Get_ZBuffer_At(x, y))
+			{
+				int TextureX = abs((int)((SpanU + (StepU * (x - SpanX0))) * TextureWidth)) % TextureWidth;
+				int TextureY = abs((int)((SpanV + (StepV * (x - SpanX0))) * TextureHeight)) % TextureHeight;
+				int TextureIndex = ((TextureWidth * TextureY) + TextureX) % (Get_Window_Width() * Get_Window_Height());
+				Draw_Pixel(x, y, TextureBuffer[TextureIndex]);
+				Update_ZBuffer_At(x, y, Depth);
+			}
+		}
+
+		if (SpanX1 == XEnd - 1)
+		{
+			break;
+		}
+		SpanU = EndU;
+		SpanV = EndV;
+		SpanReciprocalW = EndReciprocalW;
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Draw a textured triangle with the flat-top/flat-bottom method
 // We split the original triangle in 2, half flat-bottom and half flat-top
@@ -420,6 +554,9 @@ void Draw_Textured_Triangle(
 	tex2_t BUV = { u1, v1 };
 	tex2_t CUV = { u2, v2 };
 
+	// Perspective span subdivision (see PERSPECTIVE_SPAN_EXACT)
+	int SpanLength = Get_Perspective_Span_Length();
+
 	/////////////////////  DRAW THE UPPER PART OF THE TRIANGLE (FLAT-BOTTOM) ///////////////////////////////////
 
 	// Calculate the 2 slopes from each triangle "leg"
@@ -456,6 +593,13 @@ void Draw_Textured_Triangle(
 				Integer_Swap(&XStart, &XEnd);
 			}
 
+			// With span subdivision, the whole row is drawn at once
+			if (SpanLength != PERSPECTIVE_SPAN_EXACT)
+			{
+				Draw_Texel_Span(XStart, XEnd, y, VertexA, VertexB, VertexC, AUV, BUV, CUV, texture, SpanLength);
+				continue;
+			}
+
 			// For each looped row, draw a texture pixel in every column, from XStart to XEnd
 			for (int x = XStart; x < XEnd; x++)
 			{
@@ -497,6 +641,12 @@ void Draw_Textured_Triangle(
 				Integer_Swap(&XStart, &XEnd);
 			}
 
+			if (SpanLength != PERSPECTIVE_SPAN_EXACT)
+			{
+				Draw_Texel_Span(XStart, XEnd, y, VertexA, VertexB, VertexC, AUV, BUV, CUV, texture, SpanLength);
+				continue;
+			}
+
 			// For each looped row, draw a texture pixel in every column, from XStart to XEnd
 			for (int x = XStart; x < XEnd; x++)
 			{
@@ -511,6 +661,1086 @@ void Draw_Textured_Triangle(
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Edge function (half-space) rasterization
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Each edge of the triangle splits the screen in 2 halves. For an edge going from P0 to P1, the function
+	Edge(P) = (P1.x - P0.x) * (P.y - P0.y) - (P1.y - P0.y) * (P.x - P0.x)
+	is the 2D cross product between the edge and the vector P0->P: positive on one side, negative on the other one
+	and zero exactly on the edge. A pixel is inside the triangle when it's on the inner side of all 3 edges.
+
+	The edge function is linear in X and Y, so moving one pixel to the right always adds -(P1.y - P0.y),
+	and moving one row down always adds (P1.x - P0.x). Also, each edge function evaluated at P is twice the
+	area of the sub-triangle made by P and that edge, so dividing it by the full area gives the same barycentric
+	weights that Barycentric_Weights calculates, but without any per pixel subtraction or division.
+*/
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Fixed point coordinates of a vertex, rounded to the nearest sub-pixel
+typedef struct
+{
+	int32_t x;
+	int32_t y;
+} fixed_point_t;
+
+static fixed_point_t Snap_To_Subpixel(vec4_t Vertex)
+{
+	fixed_point_t Snapped = { (int32_t)lrintf(Vertex.x * SUBPIXEL_SCALE), (int32_t)lrintf(Vertex.y * SUBPIXEL_SCALE) };
+	return Snapped;
+}
+
+// Build the edge equation of the edge going from P0 to P1, starting at the center of pixel (OriginX, OriginY)
+// 64 bit math for the origin, since the pixel could be far from P0. Once the triangle passed the RASTER_MAX_EXTENT
+// check, every value inside its bounding box fits in 32 bits
+static edge_equation_t Edge_Function_Setup(fixed_point_t P0, fixed_point_t P1, int OriginX, int OriginY)
+{
+	// Sample at the center of the pixel (+0.5) and not at its top-left corner
+	int64_t PixelX = ((int64_t)OriginX * SUBPIXEL_SCALE) + (SUBPIXEL_SCALE / 2);
+	int64_t PixelY = ((int64_t)OriginY * SUBPIXEL_SCALE) + (SUBPIXEL_SCALE / 2);
+
+	edge_equation_t Edge;
+	Edge.StepX = -(P1.y - P0.y) * SUBPIXEL_SCALE;
+	Edge.StepY = (P1.x - P0.x) * SUBPIXEL_SCALE;
+	Edge.Origin = (int32_t)(((int64_t)(P1.x - P0.x) * (PixelY - P0.y)) - ((int64_t)(P1.y - P0.y) * (PixelX - P0.x)));
+	return Edge;
+}
+
+// Build the plane equation of an attribute with values V0, V1, V2 at each vertex, using the edge functions
+// Attribute(P) = (Edge0(P) * V0 + Edge1(P) * V1 + Edge2(P) * V2) / Area, and since that's linear, so are its steps
+static plane_equation_t Attribute_Plane_Setup(edge_equation_t* Edges, float V0, float V1, float V2, float ReciprocalArea)
+{
+	plane_equation_t Attribute;
+	Attribute.StepX = (((float)Edges[0].StepX * V0) + ((float)Edges[1].StepX * V1) + ((float)Edges[2].StepX * V2)) * ReciprocalArea;
+	Attribute.StepY = (((float)Edges[0].StepY * V0) + ((float)Edges[1].StepY * V1) + ((float)Edges[2].StepY * V2)) * ReciprocalArea;
+	Attribute.Origin = (((float)Edges[0].Origin * V0) + ((float)Edges[1].Origin * V1) + ((float)Edges[2].Origin * V2)) * ReciprocalArea;
+	return Attribute;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Top-left fill rule
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	When a pixel center falls exactly on an edge shared by 2 triangles, it must be drawn by only one of them,
+	otherwise it's shaded twice (or not at all, with a strict > 0 test). Like Direct3D and OpenGL, the pixel
+	belongs to the triangle that has the edge on its top or on its left side:
+	- Top edge: exactly horizontal, with the rest of the triangle below it (the edge function grows downwards)
+	- Left edge: the rest of the triangle is to its right (the edge function grows to the right)
+	The values are integers, so "Edge > 0" is the same as "Edge - 1 >= 0". Subtracting 1 from the other edges
+	keeps a single ">= 0" test in every pixel loop
+*/
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool Is_Top_Left_Edge(const edge_equation_t* Edge)
+{
+	bool bIsTopEdge = (Edge->StepX == 0 && Edge->StepY > 0);
+	bool bIsLeftEdge = (Edge->StepX > 0);
+	return bIsTopEdge || bIsLeftEdge;
+}
+
+// Edge functions of the snapped triangle with its area (see Setup_Triangle), flipped so the inside is where they're positive
+// Edges keeps their real values, for the attribute planes, and CoverageEdges has the fill rule applied, for the ">= 0" tests
+// Classify_Triangle_Size only drops a triangle when it covers no pixel of the rasterizer, so both must use exactly these
+static void Setup_Edge_Functions(
+	fixed_point_t A, fixed_point_t B, fixed_point_t C, int64_t Area, int OriginX, int OriginY,
+	edge_equation_t Edges[3], edge_equation_t CoverageEdges[3]
+	)
+{
+	// Each edge is named after the vertex in front of it, so Edge0 (B->C) gives the weight of A (alpha), and so on
+	Edges[0] = Edge_Function_Setup(B, C, OriginX, OriginY);
+	Edges[1] = Edge_Function_Setup(C, A, OriginX, OriginY);
+	Edges[2] = Edge_Function_Setup(A, B, OriginX, OriginY);
+
+	for (int idx = 0; idx < 3; idx++)
+	{
+		// The vertices could come in clockwise or counter-clockwise order (e.g. with culling disabled)
+		if (Area < 0)
+		{
+			Edges[idx].StepX = -Edges[idx].StepX;
+			Edges[idx].StepY = -Edges[idx].StepY;
+			Edges[idx].Origin = -Edges[idx].Origin;
+		}
+
+		CoverageEdges[idx] = Edges[idx];
+		if (!Is_Top_Left_Edge(&Edges[idx]))
+		{
+			CoverageEdges[idx].Origin -= 1;
+		}
+	}
+}
+
+// Bounding box of the pixel centers inside the box of the snapped vertices (not clamped to the screen)
+static void Get_Pixel_Center_Box(fixed_point_t A, fixed_point_t B, fixed_point_t C, int* MinX, int* MinY, int* MaxX, int* MaxY)
+{
+	int32_t MinSnappedX = SDL_min(A.x, SDL_min(B.x, C.x));
+	int32_t MinSnappedY = SDL_min(A.y, SDL_min(B.y, C.y));
+	int32_t MaxSnappedX = SDL_max(A.x, SDL_max(B.x, C.x));
+	int32_t MaxSnappedY = SDL_max(A.y, SDL_max(B.y, C.y));
+
+	*MinX = (int)ceilf(((float)MinSnappedX / SUBPIXEL_SCALE) - 0.5f);
+	*MinY = (int)ceilf(((float)MinSnappedY / SUBPIXEL_SCALE) - 0.5f);
+	*MaxX = (int)floorf(((float)MaxSnappedX / SUBPIXEL_SCALE) - 0.5f);
+	*MaxY = (int)floorf(((float)MaxSnappedY / SUBPIXEL_SCALE) - 0.5f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Small-primitive culling
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Classify_Triangle_Size(vec4_t VertexA, vec4_t VertexB, vec4_t VertexC)
+{
+	float MinVertexX = fminf(VertexA.x, fminf(VertexB.x, VertexC.x));
+	float MinVertexY = fminf(VertexA.y, fminf(VertexB.y, VertexC.y));
+	float MaxVertexX = fmaxf(VertexA.x, fmaxf(VertexB.x, VertexC.x));
+	float MaxVertexY = fmaxf(VertexA.y, fmaxf(VertexB.y, VertexC.y));
+
+	// Same quick rejection as Setup_Triangle, those are left to it
+	if (!(MaxVertexX >= 0 && MaxVertexY >= 0 && MinVertexX <= Get_Window_Width() && MinVertexY <= Get_Window_Height()) ||
+		!(MaxVertexX - MinVertexX < SMALL_TRIANGLE_MAX_PIXELS && MaxVertexY - MinVertexY < SMALL_TRIANGLE_MAX_PIXELS))
+	{
+		return TRIANGLE_SIZE_REGULAR;
+	}
+
+	fixed_point_t SnappedA = Snap_To_Subpixel(VertexA);
+	fixed_point_t SnappedB = Snap_To_Subpixel(VertexB);
+	fixed_point_t SnappedC = Snap_To_Subpixel(VertexC);
+
+	int MinX, MinY, MaxX, MaxY;
+	Get_Pixel_Center_Box(SnappedA, SnappedB, SnappedC, &MinX, &MinY, &MaxX, &MaxY);
+
+	int64_t Area = ((int64_t)(SnappedB.x - SnappedA.x) * (SnappedC.y - SnappedA.y)) - ((int64_t)(SnappedB.y - SnappedA.y) * (SnappedC.x - SnappedA.x));
+	if (MinX > MaxX || MinY > MaxY || Area == 0)
+	{
+		return TRIANGLE_SIZE_NO_PIXEL_CENTER;
+	}
+
+	// Only the pixels on the screen can be drawn
+	MinX = SDL_max(MinX, 0);
+	MinY = SDL_max(MinY, 0);
+	MaxX = SDL_min(MaxX, Get_Window_Width() - 1);
+	MaxY = SDL_min(MaxY, Get_Window_Height() - 1);
+	if (MinX > MaxX || MinY > MaxY)
+	{
+		return TRIANGLE_SIZE_REGULAR;
+	}
+	if ((MaxX - MinX + 1) * (MaxY - MinY + 1) > SMALL_TRIANGLE_MAX_PIXELS)
+	{
+		return TRIANGLE_SIZE_REGULAR;
+	}
+
+	// Same edge functions and fill rule as Setup_Triangle, tested at each of the few pixel centers
+	edge_equation_t RealEdges[3], Edges[3];
+	Setup_Edge_Functions(SnappedA, SnappedB, SnappedC, Area, MinX, MinY, RealEdges, Edges);
+
+	for (int y = 0; y <= MaxY - MinY; y++)
+	{
+		for (int x = 0; x <= MaxX - MinX; x++)
+		{
+			int32_t Edge0 = Edges[0].Origin + (Edges[0].StepX * x) + (Edges[0].StepY * y);
+			int32_t Edge1 = Edges[1].Origin + (Edges[1].StepX * x) + (Edges[1].StepY * y);
+			int32_t Edge2 = Edges[2].Origin + (Edges[2].StepX * x) + (Edges[2].StepY * y);
+			if ((Edge0 | Edge1 | Edge2) >= 0)
+			{
+				return TRIANGLE_SIZE_SMALL;
+			}
+		}
+	}
+	return TRIANGLE_SIZE_NO_COVERAGE;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Compute the edge functions and the 1/W, U/W and V/W plane equations of a triangle
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Setup_Triangle(
+	triangle_setup_t* Setup,
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	tex2_t AUV, tex2_t BUV, tex2_t CUV
+	)
+{
+	// Quick rejection of triangles outside the screen or too big, before converting anything to fixed point
+	// Also rejects NaN coordinates, since every comparison with them is false
+	float MinVertexX = fminf(VertexA.x, fminf(VertexB.x, VertexC.x));
+	float MinVertexY = fminf(VertexA.y, fminf(VertexB.y, VertexC.y));
+	float MaxVertexX = fmaxf(VertexA.x, fmaxf(VertexB.x, VertexC.x));
+	float MaxVertexY = fmaxf(VertexA.y, fmaxf(VertexB.y, VertexC.y));
+
+	if (!(MaxVertexX >= 0 && MaxVertexY >= 0 && MinVertexX <= Get_Window_Width() && MinVertexY <= Get_Window_Height()) ||
+		!(MaxVertexX - MinVertexX < RASTER_MAX_EXTENT && MaxVertexY - MinVertexY < RASTER_MAX_EXTENT))
+	{
+		return false;
+	}
+
+	// From here on, the triangle is only seen through its vertices snapped to the sub-pixel grid
+	fixed_point_t SnappedA = Snap_To_Subpixel(VertexA);
+	fixed_point_t SnappedB = Snap_To_Subpixel(VertexB);
+	fixed_point_t SnappedC = Snap_To_Subpixel(VertexC);
+
+	int32_t MinSnappedX = SDL_min(SnappedA.x, SDL_min(SnappedB.x, SnappedC.x));
+	int32_t MinSnappedY = SDL_min(SnappedA.y, SDL_min(SnappedB.y, SnappedC.y));
+	int32_t MaxSnappedX = SDL_max(SnappedA.x, SDL_max(SnappedB.x, SnappedC.x));
+	int32_t MaxSnappedY = SDL_max(SnappedA.y, SDL_max(SnappedB.y, SnappedC.y));
+
+	// Snapping can make the triangle up to a sub-pixel bigger, so check the extent again with the exact values
+	if (MaxSnappedX - MinSnappedX >= RASTER_MAX_EXTENT * SUBPIXEL_SCALE || MaxSnappedY - MinSnappedY >= RASTER_MAX_EXTENT * SUBPIXEL_SCALE)
+	{
+		return false;
+	}
+
+	// Bounding box of the pixel centers that could be covered by the triangle, clamped to the screen
+	// That way the inner loops never need to check if the pixel is inside the screen
+	Get_Pixel_Center_Box(SnappedA, SnappedB, SnappedC, &Setup->MinX, &Setup->MinY, &Setup->MaxX, &Setup->MaxY);
+
+	if (Setup->MinX < 0) Setup->MinX = 0;
+	if (Setup->MinY < 0) Setup->MinY = 0;
+	if (Setup->MaxX > Get_Window_Width() - 1) Setup->MaxX = Get_Window_Width() - 1;
+	if (Setup->MaxY > Get_Window_Height() - 1) Setup->MaxY = Get_Window_Height() - 1;
+
+	if (Setup->MinX > Setup->MaxX || Setup->MinY > Setup->MaxY)
+	{
+		return false;
+	}
+
+	// Twice the signed area of the triangle (the edge function of AB evaluated at C), in 1/SUBPIXEL_SCALE^2 pixels
+	int64_t Area = ((int64_t)(SnappedB.x - SnappedA.x) * (SnappedC.y - SnappedA.y)) - ((int64_t)(SnappedB.y - SnappedA.y) * (SnappedC.x - SnappedA.x));
+	if (Area == 0)
+	{
+		return false;
+	}
+
+	// The pixel loops test the edges with the fill rule applied, the attributes need their real values
+	edge_equation_t Edges[3];
+	Setup_Edge_Functions(SnappedA, SnappedB, SnappedC, Area, Setup->MinX, Setup->MinY, Edges, Setup->Edges);
+	Area = (Area < 0) ? -Area : Area;
+
+	// The edge values are measured in 1/SUBPIXEL_SCALE^2 pixels too, so the scale cancels out in Edge/Area
+	float ReciprocalArea = 1.0f / (float)Area;
+
+	// Perspective correct interpolation: 1/W, U/W and V/W are linear in screen space, so those are the ones we interpolate
+	float ReciprocalWA = 1.0f / VertexA.w;
+	float ReciprocalWB = 1.0f / VertexB.w;
+	float ReciprocalWC = 1.0f / VertexC.w;
+
+	Setup->ReciprocalW = Attribute_Plane_Setup(Edges, ReciprocalWA, ReciprocalWB, ReciprocalWC, ReciprocalArea);
+	Setup->UOverW = Attribute_Plane_Setup(Edges, AUV.u * ReciprocalWA, BUV.u * ReciprocalWB, CUV.u * ReciprocalWC, ReciprocalArea);
+	Setup->VOverW = Attribute_Plane_Setup(Edges, AUV.v * ReciprocalWA, BUV.v * ReciprocalWB, CUV.v * ReciprocalWC, ReciprocalArea);
+
+	// Same depth as the pixel loops write (1 - 1/W), so the closest vertex is the one with the biggest 1/W
+	Setup->MinDepth = Get_Depth_Bias() - fmaxf(ReciprocalWA, fmaxf(ReciprocalWB, ReciprocalWC));
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pixel loops of the edge function rasterizer
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// When bTestEdges is false every pixel of the rectangle is known to be inside the triangle, so the loop
+// doesn't check the edge functions at all. These are always inlined with a constant bTestEdges, so the
+// compiler generates 2 separate loops and the check disappears from the one for fully covered blocks
+// The other flags work the same way, for the 2 passes of the depth pre-pass: bWriteColor false only writes
+// the depth (first pass), and bEqualDepth only draws the pixels that have exactly the same depth that's
+// already in the depth buffer, without writing it again (second pass). bWriteId writes the triangle ID
+// of the target into the visibility buffer instead of the color buffer
+// DepthFormat is constant too: each format of the depth buffer gets its own loops (see Make_Depth)
+// The pixels (always in screen coordinates) go to the buffers of Target: the screen, or the tile of a thread (see Tiles.c)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SDL_FORCE_INLINE int Fill_Solid_Pixels(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1, bool bTestEdges, bool bWriteColor, bool bWriteId, int DepthFormat)
+{
+	int BufferWidth = Target->Width;
+	int OriginX = Target->OriginX;
+	int OriginY = Target->OriginY;
+	color_t* ColorBuffer = bWriteId ? Target->VisibilityBuffer : Target->ColorBuffer;
+	void* ZBuffer = Target->ZBuffer;
+	color_t Color = bWriteId ? Target->TriangleId : Setup->Color;
+
+	// Copy the steps into local variables: the depth buffer can be made of floats too, so otherwise the compiler has to
+	// assume every depth write could change them, and reload them from memory in each iteration
+	int32_t Edge0StepX = Setup->Edges[0].StepX, Edge0StepY = Setup->Edges[0].StepY;
+	int32_t Edge1StepX = Setup->Edges[1].StepX, Edge1StepY = Setup->Edges[1].StepY;
+	int32_t Edge2StepX = Setup->Edges[2].StepX, Edge2StepY = Setup->Edges[2].StepY;
+	float ReciprocalWStepX = Setup->ReciprocalW.StepX, ReciprocalWStepY = Setup->ReciprocalW.StepY;
+
+	// Values of the edge functions and 1/W at the first pixel of the current row
+	int32_t RowEdge0 = Edge_Equation_At(&Setup->Edges[0], Setup, X0, Y0);
+	int32_t RowEdge1 = Edge_Equation_At(&Setup->Edges[1], Setup, X0, Y0);
+	int32_t RowEdge2 = Edge_Equation_At(&Setup->Edges[2], Setup, X0, Y0);
+	float RowReciprocalW = Plane_Equation_At(&Setup->ReciprocalW, Setup, X0, Y0);
+	int ShadedPixels = 0;
+	float DepthBias = Get_Depth_Bias(); // See DEPTH_GENERATIONS
+	float DepthScale = Get_Depth_Scale();
+
+	for (int y = Y0; y <= Y1; y++)
+	{
+		int32_t Edge0 = RowEdge0;
+		int32_t Edge1 = RowEdge1;
+		int32_t Edge2 = RowEdge2;
+		float ReciprocalW = RowReciprocalW;
+
+		int RowIndex = Pixel_Row_Offset(y - OriginY, BufferWidth);
+
+		for (int x = X0; x <= X1; x++)
+		{
+			// The pixel is inside the triangle if it's on the inner side of the 3 edges (none of them has the sign bit set)
+			if (!bTestEdges || (Edge0 | Edge1 | Edge2) >= 0)
+			{
+				int PixelIndex = RowIndex + Pixel_Column_Offset(x - OriginX);
+				depth_value_t Depth = Make_Depth(ReciprocalW, DepthBias, DepthScale, DepthFormat);
+				if (Test_Depth(ZBuffer, PixelIndex, Depth, DepthFormat, false))
+				{
+					if (bWriteColor)
+					{
+						ColorBuffer[PixelIndex] = Color;
+						ShadedPixels += bWriteId ? 0 : 1;
+					}
+					Store_Depth(ZBuffer, PixelIndex, Depth, DepthFormat);
+				}
+			}
+
+			// Moving one pixel to the right only costs additions
+			if (bTestEdges)
+			{
+				Edge0 += Edge0StepX;
+				Edge1 += Edge1StepX;
+				Edge2 += Edge2StepX;
+			}
+			ReciprocalW += ReciprocalWStepX;
+		}
+
+		// Moving one row down only costs additions too
+		RowEdge0 += Edge0StepY;
+		RowEdge1 += Edge1StepY;
+		RowEdge2 += Edge2StepY;
+		RowReciprocalW += ReciprocalWStepY;
+	}
+
+	return ShadedPixels;
+}
+
+SDL_FORCE_INLINE int Fill_Textured_Pixels(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1, bool bTestEdges, bool bEqualDepth, int DepthFormat)
+{
+	int BufferWidth = Target->Width;
+	int OriginX = Target->OriginX;
+	int OriginY = Target->OriginY;
+	color_t* ColorBuffer = Target->ColorBuffer;
+	void* ZBuffer = Target->ZBuffer;
+	color_t* TextureBuffer = Setup->TextureBuffer;
+	int TextureWidth = Setup->TextureWidth;
+	int TextureHeight = Setup->TextureHeight;
+
+	// Copy the steps into local variables: the depth buffer can be made of floats too, so otherwise the compiler has to
+	// assume every depth write could change them, and reload them from memory in each iteration
+	int32_t Edge0StepX = Setup->Edges[0].StepX, Edge0StepY = Setup->Edges[0].StepY;
+	int32_t Edge1StepX = Setup->Edges[1].StepX, Edge1StepY = Setup->Edges[1].StepY;
+	int32_t Edge2StepX = Setup->Edges[2].StepX, Edge2StepY = Setup->Edges[2].StepY;
+	float ReciprocalWStepX = Setup->ReciprocalW.StepX, ReciprocalWStepY = Setup->ReciprocalW.StepY;
+	float UOverWStepX = Setup->UOverW.StepX, UOverWStepY = Setup->UOverW.StepY;
+	float VOverWStepX = Setup->VOverW.StepX, VOverWStepY = Setup->VOverW.StepY;
+
+	// Values of the edge functions and the interpolated attributes at the first pixel of the current row
+	int32_t RowEdge0 = Edge_Equation_At(&Setup->Edges[0], Setup, X0, Y0);
+	int32_t RowEdge1 = Edge_Equation_At(&Setup->Edges[1], Setup, X0, Y0);
+	int32_t RowEdge2 = Edge_Equation_At(&Setup->Edges[2], Setup, X0, Y0);
+	float RowReciprocalW = Plane_Equation_At(&Setup->ReciprocalW, Setup, X0, Y0);
+	float RowUOverW = Plane_Equation_At(&Setup->UOverW, Setup, X0, Y0);
+	float RowVOverW = Plane_Equation_At(&Setup->VOverW, Setup, X0, Y0);
+	int ShadedPixels = 0;
+	float DepthBias = Get_Depth_Bias(); // See DEPTH_GENERATIONS
+	float DepthScale = Get_Depth_Scale();
+
+	for (int y = Y0; y <= Y1; y++)
+	{
+		int32_t Edge0 = RowEdge0;
+		int32_t Edge1 = RowEdge1;
+		int32_t Edge2 = RowEdge2;
+		float ReciprocalW = RowReciprocalW;
+		float UOverW = RowUOverW;
+		float VOverW = RowVOverW;
+
+		int RowIndex = Pixel_Row_Offset(y - OriginY, BufferWidth);
+
+		for (int x = X0; x <= X1; x++)
+		{
+			// The pixel is inside the triangle if it's on the inner side of the 3 edges (none of them has the sign bit set)
+			if (!bTestEdges || (Edge0 | Edge1 | Edge2) >= 0)
+			{
+				int PixelIndex = RowIndex + Pixel_Column_Offset(x - OriginX);
+				depth_value_t Depth = Make_Depth(ReciprocalW, DepthBias, DepthScale, DepthFormat);
+				if (Test_Depth(ZBuffer, PixelIndex, Depth, DepthFormat, bEqualDepth))
+				{
+					// Divide the interpolated U/W and V/W by the interpolated 1/W (undo the perspective transform)
+					// This is the only division left per pixel, and only for the pixels that pass the depth test
+					float W = Interpolation_Divide(1.0f, ReciprocalW);
+					int TextureX = abs((int)(UOverW * W * TextureWidth)) % TextureWidth;
+					int TextureY = abs((int)(VOverW * W * TextureHeight)) % TextureHeight;
+
+					ColorBuffer[PixelIndex] = TextureBuffer[(TextureWidth * TextureY) + TextureX];
+					ShadedPixels++;
+					if (!bEqualDepth)
+					{
+						Store_Depth(ZBuffer, PixelIndex, Depth, DepthFormat);
+					}
+				}
+			}
+
+			// Moving one pixel to the right only costs additions
+			if (bTestEdges)
+			{
+				Edge0 += Edge0StepX;
+				Edge1 += Edge1StepX;
+				Edge2 += Edge2StepX;
+			}
+			ReciprocalW += ReciprocalWStepX;
+			UOverW += UOverWStepX;
+			VOverW += VOverWStepX;
+		}
+
+		// Moving one row down only costs additions too
+		RowEdge0 += Edge0StepY;
+		RowEdge1 += Edge1StepY;
+		RowEdge2 += Edge2StepY;
+		RowReciprocalW += ReciprocalWStepY;
+		RowUOverW += UOverWStepY;
+		RowVOverW += VOverWStepY;
+	}
+
+	return ShadedPixels;
+}
+
+// Same as Fill_Textured_Pixels (the depth is stepped exactly the same way, so the equal depth pass still matches the
+// depth-only one), but the texel coordinates come from the perspective span subdivision instead of a division per pixel
+SDL_FORCE_INLINE int Fill_Textured_Span_Pixels(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1, bool bTestEdges, bool bEqualDepth, int SpanLength, int DepthFormat)
+{
+	int BufferWidth = Target->Width;
+	int OriginX = Target->OriginX;
+	int OriginY = Target->OriginY;
+	color_t* ColorBuffer = Target->ColorBuffer;
+	void* ZBuffer = Target->ZBuffer;
+	color_t* TextureBuffer = Setup->TextureBuffer;
+	int TextureWidth = Setup->TextureWidth;
+	int TextureHeight = Setup->TextureHeight;
+	float ReciprocalSpanLength = 1.0f / SpanLength;
+
+	int32_t Edge0StepX = Setup->Edges[0].StepX, Edge0StepY = Setup->Edges[0].StepY;
+	int32_t Edge1StepX = Setup->Edges[1].StepX, Edge1StepY = Setup->Edges[1].StepY;
+	int32_t Edge2StepX = Setup->Edges[2].StepX, Edge2StepY = Setup->Edges[2].StepY;
+	float ReciprocalWStepX = Setup->ReciprocalW.StepX, ReciprocalWStepY = Setup->ReciprocalW.StepY;
+	float UOverWStepX = Setup->UOverW.StepX, UOverWStepY = Setup->UOverW.StepY;
+	float VOverWStepX = Setup->VOverW.StepX, VOverWStepY = Setup->VOverW.StepY;
+
+	int32_t RowEdge0 = Edge_Equation_At(&Setup->Edges[0], Setup, X0, Y0);
+	int32_t RowEdge1 = Edge_Equation_At(&Setup->Edges[1], Setup, X0, Y0);
+	int32_t RowEdge2 = Edge_Equation_At(&Setup->Edges[2], Setup, X0, Y0);
+	float RowReciprocalW = Plane_Equation_At(&Setup->ReciprocalW, Setup, X0, Y0);
+	float RowUOverW = Plane_Equation_At(&Setup->UOverW, Setup, X0, Y0);
+	float RowVOverW = Plane_Equation_At(&Setup->VOverW, Setup, X0, Y0);
+	int ShadedPixels = 0;
+	float DepthBias = Get_Depth_Bias(); // See DEPTH_GENERATIONS
+	float DepthScale = Get_Depth_Scale();
+
+	for (int y = Y0; y <= Y1; y++)
+	{
+		// The spans only cover the pixels inside the triangle, so both of their ends always have a valid 1/W.
+		// That run is also all the edge tests the row needs: the pixels between its ends are all inside
+		int RunX0 = X0;
+		int RunX1 = X1;
+		if (!bTestEdges || Find_Covered_Run(Setup, RowEdge0, RowEdge1, RowEdge2, X0, X1, &RunX0, &RunX1))
+		{
+			float ReciprocalW = RowReciprocalW;
+			float UOverW = RowUOverW;
+			float VOverW = RowVOverW;
+
+			int RowIndex = Pixel_Row_Offset(y - OriginY, BufferWidth);
+
+			// The pixels before the run are still stepped one by one, so the depths are the same as Fill_Textured_Pixels'
+			for (int x = X0; x < RunX0; x++)
+			{
+				ReciprocalW += ReciprocalWStepX;
+				UOverW += UOverWStepX;
+				VOverW += VOverWStepX;
+			}
+
+			// Exact texel coordinates at the end of the previous span, reused when the next one starts there
+			int EndX = -1;
+			float EndU = 0.0f, EndV = 0.0f;
+
+			// The covered pixels are contiguous, so every span starts exactly at its first pixel
+			for (int SpanX0 = RunX0; SpanX0 <= RunX1; SpanX0 += SpanLength)
+			{
+				float SpanU, SpanV;
+				if (EndX == SpanX0)
+				{
+					SpanU = EndU;
+					SpanV = EndV;
+				}
+				else
+				{
+					Perspective_Texel_Coords(Setup, ReciprocalW, UOverW, VOverW, &SpanU, &SpanV);
+				}
+
+				// The end is the first pixel of the next span when it's inside the triangle (even past this block),
+				// otherwise the last covered pixel of the row
+				EndX = SpanX0 + SpanLength;
+				int32_t EndOffset = EndX - X0;
+				bool bEndIsInside = (EndX <= RunX1) || (RunX1 == X1 &&
+					((RowEdge0 + Edge0StepX * EndOffset) | (RowEdge1 + Edge1StepX * EndOffset) | (RowEdge2 + Edge2StepX * EndOffset)) >= 0);
+				if (!bEndIsInside)
+				{
+					EndX = RunX1;
+				}
+
+				float StepU = 0.0f, StepV = 0.0f;
+				int Pixels = EndX - SpanX0;
+				if (Pixels > 0)
+				{
+					Perspective_Texel_Coords(Setup, ReciprocalW + (ReciprocalWStepX * Pixels),
+						UOverW + (UOverWStepX * Pixels), VOverW + (VOverWStepX * Pixels), &EndU, &EndV);
+					float ReciprocalPixels = (Pixels == SpanLength) ? ReciprocalSpanLength : 1.0f / Pixels;
+					StepU = (EndU - SpanU) * ReciprocalPixels;
+					StepV = (EndV - SpanV) * ReciprocalPixels;
+				}
+
+				// Nothing but the depth test and the texture lookup in here: the span's pixels are all inside
+				int LastX = SDL_min(SpanX0 + SpanLength - 1, RunX1);
+				for (int x = SpanX0; x <= LastX; x++)
+				{
+					int PixelIndex = RowIndex + Pixel_Column_Offset(x - OriginX);
+					depth_value_t Depth = Make_Depth(ReciprocalW, DepthBias, DepthScale, DepthFormat);
+					if (Test_Depth(ZBuffer, PixelIndex, Depth, DepthFormat, bEqualDepth))
+					{
+						int TextureX = abs((int)(SpanU + (StepU * (x - SpanX0)))) % TextureWidth;
+						int TextureY = abs((int)(SpanV + (StepV * (x - SpanX0)))) % TextureHeight;
+
+						ColorBuffer[PixelIndex] = TextureBuffer[(TextureWidth * TextureY) + TextureX];
+						ShadedPixels++;
+						if (!bEqualDepth)
+						{
+							Store_Depth(ZBuffer, PixelIndex, Depth, DepthFormat);
+						}
+					}
+
+					ReciprocalW += ReciprocalWStepX;
+					UOverW += UOverWStepX;
+					VOverW += VOverWStepX;
+				}
+			}
+		}
+
+		RowEdge0 += Edge0StepY;
+		RowEdge1 += Edge1StepY;
+		RowEdge2 += Edge2StepY;
+		RowReciprocalW += ReciprocalWStepY;
+		RowUOverW += UOverWStepY;
+		RowVOverW += VOverWStepY;
+	}
+
+	return ShadedPixels;
+}
+
+// The exact perspective, or the span subdivision when it's enabled
+SDL_FORCE_INLINE int Fill_Textured_Block(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1, bool bTestEdges, bool bEqualDepth, int DepthFormat)
+{
+	int SpanLength = Get_Perspective_Span_Length();
+	if (SpanLength != PERSPECTIVE_SPAN_EXACT)
+	{
+		return Fill_Textured_Span_Pixels(Setup, Target, X0, Y0, X1, Y1, bTestEdges, bEqualDepth, SpanLength, DepthFormat);
+	}
+	return Fill_Textured_Pixels(Setup, Target, X0, Y0, X1, Y1, bTestEdges, bEqualDepth, DepthFormat);
+}
+
+int Fill_Solid_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels, Setup, Target, X0, Y0, X1, Y1, true, true, false);
+}
+
+int Fill_Solid_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels, Setup, Target, X0, Y0, X1, Y1, false, true, false);
+}
+
+int Fill_Textured_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Textured_Block, Setup, Target, X0, Y0, X1, Y1, true, false);
+}
+
+int Fill_Textured_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Textured_Block, Setup, Target, X0, Y0, X1, Y1, false, false);
+}
+
+int Fill_Depth_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels, Setup, Target, X0, Y0, X1, Y1, true, false, false);
+}
+
+int Fill_Depth_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels, Setup, Target, X0, Y0, X1, Y1, false, false, false);
+}
+
+int Fill_Visibility_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels, Setup, Target, X0, Y0, X1, Y1, true, true, true);
+}
+
+int Fill_Visibility_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels, Setup, Target, X0, Y0, X1, Y1, false, true, true);
+}
+
+int Fill_Textured_Equal_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Textured_Block, Setup, Target, X0, Y0, X1, Y1, true, true);
+}
+
+int Fill_Textured_Equal_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Textured_Block, Setup, Target, X0, Y0, X1, Y1, false, true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hierarchical Z: reject whole triangles or blocks hidden behind what's already drawn
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	The coarse depth buffer keeps the farthest depth of each block of pixels. If the closest point of the triangle
+	inside a block is still farther than that, every pixel of the block would fail the depth test, so the block
+	(or the whole triangle, if that happens in all the blocks it touches) can be skipped without any per pixel work.
+
+	  block max depth ----------- (farthest pixel already drawn in the block)
+	  triangle min depth -------  (closest point of the triangle in the block)  => visible, rasterize it
+	  ...
+	  block max depth ----------
+	  triangle min depth ------------- (behind everything in the block)        => hidden, skip it
+*/
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Recompute the farthest depth of the block that starts at pixel (BlockX,BlockY), clipped to the screen
+// Only used with the float depth buffer (see Is_Hierarchical_Z)
+static float Get_Block_Max_Depth(const render_target_t* Target, int BlockX, int BlockY)
+{
+	int WindowWidth = Get_Window_Width();
+	float* ZBuffer = (float*)Target->ZBuffer;
+
+	int X1 = (BlockX + RASTER_BLOCK_SIZE < WindowWidth) ? BlockX + RASTER_BLOCK_SIZE : WindowWidth;
+	int Y1 = (BlockY + RASTER_BLOCK_SIZE < Get_Window_Height()) ? BlockY + RASTER_BLOCK_SIZE : Get_Window_Height();
+
+	int BufferWidth = Target->Width;
+	float MaxDepth = ZBuffer[Pixel_Row_Offset(BlockY - Target->OriginY, BufferWidth) + Pixel_Column_Offset(BlockX - Target->OriginX)];
+	for (int y = BlockY; y < Y1; y++)
+	{
+		float* DepthRow = &ZBuffer[Pixel_Row_Offset(y - Target->OriginY, BufferWidth)];
+		for (int x = BlockX; x < X1; x++)
+		{
+			MaxDepth = fmaxf(MaxDepth, DepthRow[Pixel_Column_Offset(x - Target->OriginX)]);
+		}
+	}
+	return MaxDepth;
+}
+
+// Check if the part of the triangle inside the rectangle (X0,Y0)-(X1,Y1) of a block is behind the block's farthest depth
+// With bEqualDepth (second pass of the depth pre-pass) the pixels exactly at the farthest depth still have to be drawn
+static bool Is_Block_Occluded(const triangle_setup_t* Setup, int X0, int Y0, int X1, int Y1, float BlockMaxDepth, bool bEqualDepth)
+{
+	// 1/W is linear, so its biggest value in the rectangle (the closest point) is at one of the corners
+	// The plane keeps going outside of the triangle, where it can get bigger than any real 1/W, so the closest
+	// vertex is a limit too
+	const plane_equation_t* ReciprocalW = &Setup->ReciprocalW;
+	float DeltaX = ReciprocalW->StepX * (X1 - X0);
+	float DeltaY = ReciprocalW->StepY * (Y1 - Y0);
+	float MaxReciprocalW = Plane_Equation_At(ReciprocalW, Setup, X0, Y0) + fmaxf(DeltaX, 0) + fmaxf(DeltaY, 0);
+
+	float MinDepth = fmaxf(Get_Depth_Bias() - MaxReciprocalW, Setup->MinDepth);
+	return bEqualDepth ? (MinDepth > BlockMaxDepth) : (MinDepth >= BlockMaxDepth);
+}
+
+// Check the whole triangle at once: it's hidden if it's behind the farthest depth of every block of the rectangle
+static bool Is_Triangle_Occluded(const triangle_setup_t* Setup, int MinX, int MinY, int MaxX, int MaxY, bool bEqualDepth)
+{
+	float* BlockMaxDepth = Get_ZBuffer_Block_Max();
+	int DepthBlocksPerRow = Get_Depth_Blocks_Per_Row();
+
+	for (int BlockY = MinY / RASTER_BLOCK_SIZE; BlockY <= MaxY / RASTER_BLOCK_SIZE; BlockY++)
+	{
+		for (int BlockX = MinX / RASTER_BLOCK_SIZE; BlockX <= MaxX / RASTER_BLOCK_SIZE; BlockX++)
+		{
+			float BlockDepth = BlockMaxDepth[(BlockY * DepthBlocksPerRow) + BlockX];
+			if (Setup->MinDepth < BlockDepth || (bEqualDepth && Setup->MinDepth == BlockDepth))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Loop the blocks of the triangle's bounding box, classifying each one before touching its pixels
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Since the edge functions are linear, their smallest and biggest values inside a block are always at 2 of its
+	corners. So with just the corners we know if the block is:
+	- Fully outside: the biggest value of some edge is negative, nothing to draw (trivial reject)
+	- Fully inside: the smallest value of every edge is positive, draw it without testing any pixel (trivial accept)
+	- Partially covered: only these blocks test the edge functions per pixel
+
+	+--------+--------+--------+
+	|        |     /\ |        |     Outside blocks are skipped
+	|        |   /  |\|        |
+	+--------+-/----|-\--------+
+	|        /Inside|  \       |     Partial blocks test each pixel
+	|      / |      |    \     |
+	+----/---+------+------\---+
+*/
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Draw a run of neighbour blocks of a block row, (RunX0,Y0)-(RunX1,Y1), with a single kernel call. The masks have one
+// bit per block of the run (starting at the block at RunBlockX): blocks fully inside the triangle, and blocks occluded
+static int Draw_Block_Run(
+	const triangle_setup_t* Setup,
+	const render_target_t* Target,
+	int RunX0, int Y0, int RunX1, int Y1,
+	int RunBlockX, int BlockY, uint32_t FullBlocks, uint32_t OccludedBlocks, int NumBlocks,
+	raster_block_kernel_t FullBlockKernel,
+	raster_block_kernel_t PartialBlockKernel,
+	bool bUpdateBlockMax // Recompute the farthest depth of the fully covered blocks afterwards
+	)
+{
+	uint32_t AllBlocks = (NumBlocks == 32) ? 0xFFFFFFFF : ((1u << NumBlocks) - 1);
+	if (OccludedBlocks == AllBlocks)
+	{
+		return 0;
+	}
+
+	int ShadedPixels = (FullBlocks == AllBlocks) ?
+		FullBlockKernel(Setup, Target, RunX0, Y0, RunX1, Y1) : PartialBlockKernel(Setup, Target, RunX0, Y0, RunX1, Y1);
+
+	if (bUpdateBlockMax)
+	{
+		float* BlockMaxDepth = Get_ZBuffer_Block_Max();
+		int RowBlockIndex = (BlockY / RASTER_BLOCK_SIZE) * Get_Depth_Blocks_Per_Row();
+		for (int idx = 0; idx < NumBlocks; idx++)
+		{
+			if (FullBlocks & (1u << idx))
+			{
+				int BlockX = RunBlockX + (idx * RASTER_BLOCK_SIZE);
+				BlockMaxDepth[RowBlockIndex + (BlockX / RASTER_BLOCK_SIZE)] = Get_Block_Max_Depth(Target, BlockX, BlockY);
+			}
+		}
+	}
+	return ShadedPixels;
+}
+
+static int Rasterize_Triangle_Blocks(
+	const triangle_setup_t* Setup,
+	const render_target_t* Target,
+	int MinX, int MinY, int MaxX, int MaxY, // Part of the bounding box to rasterize (the whole box, or a screen tile of it)
+	raster_block_kernel_t FullBlockKernel,
+	raster_block_kernel_t PartialBlockKernel,
+	bool bEqualDepth, // The kernels only draw the pixels at the same depth of the depth buffer, and don't change it
+	bool bJoinBlocks // Draw the neighbour blocks of a row with a single kernel call (the perspective spans go across blocks)
+	)
+{
+	int BoxWidth = MaxX - MinX + 1;
+	int BoxHeight = MaxY - MinY + 1;
+
+	// Small triangles don't cover enough blocks to pay for the classification, so just test all their pixels
+	if (BoxWidth < RASTER_BLOCK_SIZE || BoxHeight < RASTER_BLOCK_SIZE ||
+		(BoxWidth * BoxHeight) < (MIN_BLOCKS_FOR_HIERARCHICAL_RASTER * RASTER_BLOCK_SIZE * RASTER_BLOCK_SIZE))
+	{
+		return PartialBlockKernel(Setup, Target, MinX, MinY, MaxX, MaxY);
+	}
+
+	bool bUseHierarchicalZ = Is_Hierarchical_Z();
+	float* BlockMaxDepth = Get_ZBuffer_Block_Max();
+	int DepthBlocksPerRow = Get_Depth_Blocks_Per_Row();
+
+	// Blocks are aligned to the screen (not to the bounding box), starting at the block that contains the first pixel
+	int FirstBlockX = MinX - (MinX % RASTER_BLOCK_SIZE);
+	int FirstBlockY = MinY - (MinY % RASTER_BLOCK_SIZE);
+	int ShadedPixels = 0;
+
+	for (int BlockY = FirstBlockY; BlockY <= MaxY; BlockY += RASTER_BLOCK_SIZE)
+	{
+		// Clip the block to the bounding box, so we never loop pixels outside of it
+		int Y0 = (BlockY < MinY) ? MinY : BlockY;
+		int Y1 = (BlockY + RASTER_BLOCK_SIZE - 1 > MaxY) ? MaxY : BlockY + RASTER_BLOCK_SIZE - 1;
+
+		// Blocks waiting to be drawn together, with bJoinBlocks
+		int RunX0 = 0, RunX1 = 0, RunBlockX = 0, NumRunBlocks = 0;
+		uint32_t FullRunBlocks = 0, OccludedRunBlocks = 0;
+
+		for (int BlockX = FirstBlockX; BlockX <= MaxX; BlockX += RASTER_BLOCK_SIZE)
+		{
+			int X0 = (BlockX < MinX) ? MinX : BlockX;
+			int X1 = (BlockX + RASTER_BLOCK_SIZE - 1 > MaxX) ? MaxX : BlockX + RASTER_BLOCK_SIZE - 1;
+
+			bool bIsOutside = false;
+			bool bIsFullyInside = true;
+
+			for (int idx = 0; idx < 3; idx++)
+			{
+				const edge_equation_t* Edge = &Setup->Edges[idx];
+
+				// Value at the top-left pixel of the block, plus how much it changes to reach the other corners
+				int32_t CornerValue = Edge_Equation_At(Edge, Setup, X0, Y0);
+				int32_t DeltaX = Edge->StepX * (X1 - X0);
+				int32_t DeltaY = Edge->StepY * (Y1 - Y0);
+
+				int32_t MinValue = CornerValue + ((DeltaX < 0) ? DeltaX : 0) + ((DeltaY < 0) ? DeltaY : 0);
+				int32_t MaxValue = CornerValue + ((DeltaX > 0) ? DeltaX : 0) + ((DeltaY > 0) ? DeltaY : 0);
+
+				if (MaxValue < 0)
+				{
+					bIsOutside = true;
+					break;
+				}
+				if (MinValue < 0)
+				{
+					bIsFullyInside = false;
+				}
+			}
+
+			if (bIsOutside)
+			{
+				continue;
+			}
+
+			int BlockIndex = ((BlockY / RASTER_BLOCK_SIZE) * DepthBlocksPerRow) + (BlockX / RASTER_BLOCK_SIZE);
+			bool bIsOccluded = bUseHierarchicalZ && Is_Block_Occluded(Setup, X0, Y0, X1, Y1, BlockMaxDepth[BlockIndex], bEqualDepth);
+
+			if (bJoinBlocks)
+			{
+				// The runs only depend on the triangle (an occluded block stays in its run), so the depth pre-pass and
+				// the textured pass make the same kernel calls and interpolate exactly the same depths
+				if (NumRunBlocks > 0 && (X0 != RunX1 + 1 || NumRunBlocks == 32))
+				{
+					ShadedPixels += Draw_Block_Run(Setup, Target, RunX0, Y0, RunX1, Y1, RunBlockX, BlockY, FullRunBlocks, OccludedRunBlocks,
+						NumRunBlocks, FullBlockKernel, PartialBlockKernel, bUseHierarchicalZ && !bEqualDepth);
+					NumRunBlocks = 0;
+				}
+				if (NumRunBlocks == 0)
+				{
+					RunX0 = X0;
+					RunBlockX = BlockX;
+					FullRunBlocks = 0;
+					OccludedRunBlocks = 0;
+				}
+				RunX1 = X1;
+				FullRunBlocks |= bIsFullyInside ? (1u << NumRunBlocks) : 0;
+				OccludedRunBlocks |= bIsOccluded ? (1u << NumRunBlocks) : 0;
+				NumRunBlocks++;
+			}
+			else if (bIsOccluded)
+			{
+				continue;
+			}
+			else if (bIsFullyInside)
+			{
+				ShadedPixels += FullBlockKernel(Setup, Target, X0, Y0, X1, Y1);
+
+				// Every pixel of the block that the triangle touches got a new depth (or already had a closer one)
+				// so this is where the farthest depth of the block has the best chances of getting closer
+				if (bUseHierarchicalZ && !bEqualDepth)
+				{
+					BlockMaxDepth[BlockIndex] = Get_Block_Max_Depth(Target, BlockX, BlockY);
+				}
+			}
+			else
+			{
+				ShadedPixels += PartialBlockKernel(Setup, Target, X0, Y0, X1, Y1);
+			}
+		}
+
+		if (NumRunBlocks > 0)
+		{
+			ShadedPixels += Draw_Block_Run(Setup, Target, RunX0, Y0, RunX1, Y1, RunBlockX, BlockY, FullRunBlocks, OccludedRunBlocks,
+				NumRunBlocks, FullBlockKernel, PartialBlockKernel, bUseHierarchicalZ && !bEqualDepth);
+		}
+	}
+
+	return ShadedPixels;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Block loops of each kind of pass, indexed by [SIMD or not][kind of pass]
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum EBlock_Kernels {
+	KERNELS_SOLID,
+	KERNELS_TEXTURED,
+	KERNELS_DEPTH_ONLY,
+	KERNELS_TEXTURED_EQUAL,
+	KERNELS_VISIBILITY,
+	NUM_BLOCK_KERNELS
+};
+
+static const raster_block_kernel_t FullBlockKernels[2][NUM_BLOCK_KERNELS] = {
+	{ Fill_Solid_Block_Full, Fill_Textured_Block_Full, Fill_Depth_Block_Full, Fill_Textured_Equal_Block_Full, Fill_Visibility_Block_Full },
+	{ Fill_Solid_Block_Full_SIMD, Fill_Textured_Block_Full_SIMD, Fill_Depth_Block_Full_SIMD, Fill_Textured_Equal_Block_Full_SIMD, Fill_Visibility_Block_Full_SIMD }
+};
+
+static const raster_block_kernel_t PartialBlockKernels[2][NUM_BLOCK_KERNELS] = {
+	{ Fill_Solid_Block_Partial, Fill_Textured_Block_Partial, Fill_Depth_Block_Partial, Fill_Textured_Equal_Block_Partial, Fill_Visibility_Block_Partial },
+	{ Fill_Solid_Block_Partial_SIMD, Fill_Textured_Block_Partial_SIMD, Fill_Depth_Block_Partial_SIMD, Fill_Textured_Equal_Block_Partial_SIMD, Fill_Visibility_Block_Partial_SIMD }
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Rasterize the part of a triangle that falls inside the rectangle (X0,Y0)-(X1,Y1)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Rasterize_Triangle_Rect(const triangle_setup_t* Setup, const render_target_t* Target, int Pass, int X0, int Y0, int X1, int Y1)
+{
+	// Filled triangles don't have a texture
+	bool bIsTextured = (Setup->TextureBuffer != NULL);
+	bool bEqualDepth = (Pass == RASTER_PASS_EQUAL_DEPTH);
+
+	int Kernels;
+	switch (Pass)
+	{
+	case RASTER_PASS_DEPTH_ONLY:
+		// Only textured triangles have a shading expensive enough to need the depth pre-pass,
+		// a filled triangle writes its color right away (it costs the same as writing the depth alone)
+		Kernels = bIsTextured ? KERNELS_DEPTH_ONLY : KERNELS_SOLID;
+		break;
+	case RASTER_PASS_EQUAL_DEPTH:
+		// Filled triangles were already drawn by the depth-only pass
+		if (!bIsTextured)
+		{
+			return 0;
+		}
+		Kernels = KERNELS_TEXTURED_EQUAL;
+		break;
+	case RASTER_PASS_VISIBILITY:
+		Kernels = KERNELS_VISIBILITY;
+		break;
+	default:
+		Kernels = bIsTextured ? KERNELS_TEXTURED : KERNELS_SOLID;
+		break;
+	}
+
+	// Only the pixels inside both the rectangle and the bounding box
+	int MinX = (X0 > Setup->MinX) ? X0 : Setup->MinX;
+	int MinY = (Y0 > Setup->MinY) ? Y0 : Setup->MinY;
+	int MaxX = (X1 < Setup->MaxX) ? X1 : Setup->MaxX;
+	int MaxY = (Y1 < Setup->MaxY) ? Y1 : Setup->MaxY;
+
+	if (MinX > MaxX || MinY > MaxY)
+	{
+		return 0;
+	}
+
+	// Small triangles: a few pixels aren't worth the hierarchical Z test, the block classification or the SIMD loops
+	if ((Setup->MaxX - Setup->MinX + 1) * (Setup->MaxY - Setup->MinY + 1) <= SMALL_TRIANGLE_MAX_PIXELS)
+	{
+		return PartialBlockKernels[0][Kernels](Setup, Target, MinX, MinY, MaxX, MaxY);
+	}
+
+	// The closest vertex is cheaper to test than the 1/W plane, and hides most of the triangles that are fully hidden
+	if (Is_Hierarchical_Z() && Is_Triangle_Occluded(Setup, MinX, MinY, MaxX, MaxY, bEqualDepth))
+	{
+		return 0;
+	}
+
+	// The perspective spans restart at the first pixel of each kernel call, so with the subdivision the textured
+	// kernels get whole runs of blocks instead of one block at a time (otherwise 16 pixel spans would stop at 8 pixels).
+	// The depth pre-pass is joined the same way, so the equal depth pass finds exactly the depths it wrote.
+	// The SIMD loops are always exact, so they keep their full blocks
+	int SIMD = Is_Raster_SIMD() ? 1 : 0;
+	bool bJoinBlocks = (Kernels == KERNELS_TEXTURED || Kernels == KERNELS_TEXTURED_EQUAL || Kernels == KERNELS_DEPTH_ONLY) &&
+		(Get_Perspective_Span_Length() != PERSPECTIVE_SPAN_EXACT) && !SIMD;
+
+	return Rasterize_Triangle_Blocks(Setup, Target, MinX, MinY, MaxX, MaxY, FullBlockKernels[SIMD][Kernels], PartialBlockKernels[SIMD][Kernels],
+		bEqualDepth, bJoinBlocks);
+}
+
+void Draw_Triangle_Setup(const triangle_setup_t* Setup)
+{
+	Add_Shaded_Pixels(Rasterize_Triangle_Rect(Setup, Get_Screen_Target(), RASTER_PASS_COLOR, Setup->MinX, Setup->MinY, Setup->MaxX, Setup->MaxY));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Setup a filled or textured triangle, ready to be rasterized later (e.g. by the tile threads)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Setup_Filled_Triangle(
+	triangle_setup_t* Setup,
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	color_t Color
+	)
+{
+	tex2_t NoUV = { 0, 0 };
+	if (!Setup_Triangle(Setup, VertexA, VertexB, VertexC, NoUV, NoUV, NoUV))
+	{
+		return false;
+	}
+
+	Setup->Color = Color;
+	Setup->TextureBuffer = NULL;
+	return true;
+}
+
+bool Setup_Textured_Triangle(
+	triangle_setup_t* Setup,
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	tex2_t AUV, tex2_t BUV, tex2_t CUV,
+	upng_t* Texture
+	)
+{
+	// Flip the V component to account for innverted V-Coordinates (V is growing downwards by default)
+	AUV.v = 1.0f - AUV.v;
+	BUV.v = 1.0f - BUV.v;
+	CUV.v = 1.0f - CUV.v;
+
+	if (!Setup_Triangle(Setup, VertexA, VertexB, VertexC, AUV, BUV, CUV))
+	{
+		return false;
+	}
+
+	// Get the current mesh's texture dimensions and buffer of colors only once per triangle
+	Setup->TextureWidth = upng_get_width(Texture);
+	Setup->TextureHeight = upng_get_height(Texture);
+	Setup->TextureBuffer = (color_t*)upng_get_buffer(Texture);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Draw a filled triangle with incrementally stepped edge functions
+///////////////////////////////////////////////////////////////////////////////
+
+void Draw_Filled_Triangle_Edge_Function(
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	color_t Color
+	)
+{
+	triangle_setup_t Setup;
+	if (Setup_Filled_Triangle(&Setup, VertexA, VertexB, VertexC, Color))
+	{
+		Draw_Triangle_Setup(&Setup);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Draw a textured triangle with incrementally stepped edge functions
+///////////////////////////////////////////////////////////////////////////////
+
+void Draw_Textured_Triangle_Edge_Function(
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	tex2_t AUV, tex2_t BUV, tex2_t CUV,
+	upng_t* Texture
+	)
+{
+	triangle_setup_t Setup;
+	if (Setup_Textured_Triangle(&Setup, VertexA, VertexB, VertexC, AUV, BUV, CUV, Texture))
+	{
+		Draw_Triangle_Setup(&Setup);
+	}
+}
+
+float Get_Triangle_Screen_Area(vec4_t VertexA, vec4_t VertexB, vec4_t VertexC)
+{
+	return ((VertexB.x - VertexA.x) * (VertexC.y - VertexA.y)) - ((VertexB.y - VertexA.y) * (VertexC.x - VertexA.x));
+}
+
 vec3_t Get_Triangle_Normal(vec4_t* TriangleVertices)
 {
 	vec3_t VectorA = Vec4_To_Vec3(TriangleVertices[0]);  /*   A	    */
@@ -4,6 +4,7 @@
 #define TRIANGLE_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "Vector.h"
 #include "Display.h"
 #include "Texture.h"
@@ -36,6 +37,217 @@ typedef struct
 	upng_t* texture;
 } Triangle_t;
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Declare a new type to hold a value that changes linearly across the screen (a plane equation)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Value(x,y) = Origin + (StepX * columns moved) + (StepY * rows moved), starting at the first pixel of the bounding box
+// So moving one pixel to the right is just "Value += StepX", and moving one row down is just "Value += StepY"
+typedef struct
+{
+	float StepX;
+	float StepY;
+	float Origin;
+} plane_equation_t;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Declare a new type to hold an edge function in fixed point
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	The vertices are snapped to a grid of 1/SUBPIXEL_SCALE of a pixel (28.4 fixed point) before building the edge
+	functions, so they're evaluated with exact integer math: two triangles that share an edge get exactly opposite
+	values along it, no matter in which order (or in which thread, or in which block) their pixels are visited.
+	Same stepping as plane_equation_t, but the values are in 1/(SUBPIXEL_SCALE * SUBPIXEL_SCALE) of a pixel squared.
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define SUBPIXEL_BITS 4
+#define SUBPIXEL_SCALE (1 << SUBPIXEL_BITS)
+
+// The edge functions multiply 2 distances between points of the triangle's bounding box, so with 32 bit integers the
+// triangles must be smaller than this (in pixels, both in width and height). Bigger ones aren't drawn
+#define RASTER_MAX_EXTENT 2048
+
+typedef struct
+{
+	int32_t StepX;
+	int32_t StepY;
+	int32_t Origin;
+} edge_equation_t;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Declare a new type to hold everything the edge function rasterizer needs, computed only once per triangle
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	edge_equation_t Edges[3]; // Edge functions, >= 0 on the inner side of each edge (opposite to vertices A, B and C)
+	plane_equation_t ReciprocalW; // 1/W, which is linear in screen space (W itself isn't)
+	plane_equation_t UOverW; // U/W, divided by the interpolated 1/W to get the perspective correct U
+	plane_equation_t VOverW; // V/W, divided by the interpolated 1/W to get the perspective correct V
+	float MinDepth; // Depth of the closest vertex, no pixel of the triangle can be closer than this
+	int MinX; // Bounding box of the triangle, already clamped to the screen
+	int MinY;
+	int MaxX;
+	int MaxY;
+	color_t Color; // Solid color of filled triangles
+	color_t* TextureBuffer; // Texture colors, width and height of textured triangles (NULL for filled triangles)
+	int TextureWidth;
+	int TextureHeight;
+} triangle_setup_t;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hierarchical rasterization
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The screen is split in blocks of RASTER_BLOCK_SIZE x RASTER_BLOCK_SIZE pixels, and the 3 edge functions are checked
+// against each whole block before looking at any of its pixels. They're the same blocks as the coarse depth buffer
+#define RASTER_BLOCK_SIZE DEPTH_BLOCK_SIZE
+// Triangles with a bounding box smaller than this (in blocks) skip the block classification and test every pixel
+#define MIN_BLOCKS_FOR_HIERARCHICAL_RASTER 4
+
+// Triangles with this many pixel centers in their bounding box (or less) are small: they skip the hierarchical Z test
+// and the block loops, and go straight to the scalar pixel loop
+#define SMALL_TRIANGLE_MAX_PIXELS 4
+
+// How the geometry stage classifies a projected triangle by its size (see Classify_Triangle_Size)
+enum ETriangle_Size_Class {
+	TRIANGLE_SIZE_NO_PIXEL_CENTER, // No pixel center inside its bounding box (or no area): culled
+	TRIANGLE_SIZE_NO_COVERAGE, // Small, but none of the pixel centers of its bounding box is inside it: culled
+	TRIANGLE_SIZE_SMALL, // Small, and covers some pixel: rasterized by the small triangle path
+	TRIANGLE_SIZE_REGULAR,
+	NUM_TRIANGLE_SIZE_CLASSES
+};
+
+// What each rasterization pass tests and writes. The depth pre-pass draws every triangle twice: first only their
+// depth, and then the color of the pixels that ended up with exactly their depth (the visible ones)
+enum ERaster_Pass {
+	RASTER_PASS_COLOR, // Depth test (closer), write the color and the depth
+	RASTER_PASS_DEPTH_ONLY, // Depth test (closer), write only the depth (filled triangles write their color too)
+	RASTER_PASS_EQUAL_DEPTH, // Depth test (same depth), write only the color (textured triangles only)
+	RASTER_PASS_VISIBILITY // Depth test (closer), write the depth and the triangle ID of the target in the visibility buffer
+};
+
+// Loop the pixels of the rectangle (X0,Y0)-(X1,Y1) that belongs to a triangle (both corners included)
+// into the buffers of Target, and return how many of them got a new color (the depth-only pass doesn't shade any pixel)
+typedef int (*raster_block_kernel_t)(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Evaluate a plane (or edge) equation at pixel (x,y) of the triangle's bounding box
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SDL_FORCE_INLINE float Plane_Equation_At(const plane_equation_t* Plane, const triangle_setup_t* Setup, int x, int y)
+{
+	return Plane->Origin + (Plane->StepX * (x - Setup->MinX)) + (Plane->StepY * (y - Setup->MinY));
+}
+
+SDL_FORCE_INLINE int32_t Edge_Equation_At(const edge_equation_t* Edge, const triangle_setup_t* Setup, int x, int y)
+{
+	return Edge->Origin + (Edge->StepX * (x - Setup->MinX)) + (Edge->StepY * (y - Setup->MinY));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Divisions of the perspective interpolation (1/W, and U and V divided by the interpolated 1/W)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Compiling with FAST_RECIPROCAL defined (/DFAST_RECIPROCAL in MSVC, -DFAST_RECIPROCAL in GCC/Clang) replaces these
+	divisions with the approximate reciprocal instruction (rcpss/rcpps, 12 bits of precision) and one Newton-Raphson
+	step, R * (2 - X * R), which gets it to about 22 bits. It's a multiply-add chain instead of a division that
+	blocks the divider for ~11 cycles (and the whole vector on AVX). Report_Fast_Reciprocal_Accuracy prints how far
+	it is from the exact division (run with --report-reciprocal). Without FAST_RECIPROCAL (the default) they're
+	regular divisions.
+*/
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(FAST_RECIPROCAL) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#define INTERPOLATION_FAST_RECIPROCAL
+
+// Approximate 1/X refined with one Newton-Raphson step
+SDL_FORCE_INLINE float Fast_Reciprocal(float X)
+{
+	float Estimate = _mm_cvtss_f32(_mm_rcp_ss(_mm_set_ss(X)));
+	return Estimate * (2.0f - (X * Estimate));
+}
+
+// Compare Fast_Reciprocal with the exact division for every float mantissa, and print the errors to the console
+void Report_Fast_Reciprocal_Accuracy(void);
+#endif
+
+// Numerator / Denominator for the perspective interpolation of the pixels
+SDL_FORCE_INLINE float Interpolation_Divide(float Numerator, float Denominator)
+{
+#if defined(INTERPOLATION_FAST_RECIPROCAL)
+	return Numerator * Fast_Reciprocal(Denominator);
+#else
+	return Numerator / Denominator;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Perspective span subdivision (see PERSPECTIVE_SPAN_EXACT), shared by the scalar and span buffer loops
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Each row of a triangle is cut in spans of Get_Perspective_Span_Length() pixels. The texel coordinates are only
+	perspective correct at the first pixel of every span, and go linearly from there to the exact ones at the
+	first pixel of the next span (or at the last pixel of the row), so there's one division per span instead of
+	one per pixel. Both ends of every span are inside the triangle, where 1/W is never zero.
+	While the subdivision is on, the neighbour blocks of a row go to a single kernel call (see Draw_Block_Run),
+	so the spans aren't cut short at the edges of the 8x8 blocks.
+	The SIMD group loops stay exact (only the scalar heads and tails of their rows use the spans): one vector
+	division already covers a whole group of pixels, and interpolating the spans per lane measured slower than it.
+*/
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Texel coordinates (before wrapping them to the texture size) of a pixel from its interpolated 1/W, U/W and V/W
+SDL_FORCE_INLINE void Perspective_Texel_Coords(const triangle_setup_t* Setup, float ReciprocalW, float UOverW, float VOverW, float* TexelU, float* TexelV)
+{
+	float W = Interpolation_Divide(1.0f, ReciprocalW);
+	*TexelU = UOverW * W * Setup->TextureWidth;
+	*TexelV = VOverW * W * Setup->TextureHeight;
+}
+
+// First and last pixels of the row X0..X1 that are inside the triangle, given the edge functions at X0
+// Triangles are convex, so the covered pixels of a row are always a single run. Returns false if there's none
+SDL_FORCE_INLINE bool Find_Covered_Run(const triangle_setup_t* Setup, int32_t Edge0, int32_t Edge1, int32_t Edge2, int X0, int X1, int* RunX0, int* RunX1)
+{
+	int x = X0;
+	for (; x <= X1; x++)
+	{
+		if ((Edge0 | Edge1 | Edge2) >= 0)
+		{
+			break;
+		}
+		Edge0 += Setup->Edges[0].StepX;
+		Edge1 += Setup->Edges[1].StepX;
+		Edge2 += Setup->Edges[2].StepX;
+	}
+	if (x > X1)
+	{
+		return false;
+	}
+
+	*RunX0 = x;
+
+	// The last one is searched from the other end, so a long covered run is never walked pixel by pixel
+	int32_t Offset = X1 - x;
+	Edge0 += Setup->Edges[0].StepX * Offset;
+	Edge1 += Setup->Edges[1].StepX * Offset;
+	Edge2 += Setup->Edges[2].StepX * Offset;
+	for (x = X1; x > *RunX0; x--)
+	{
+		if ((Edge0 | Edge1 | Edge2) >= 0)
+		{
+			break;
+		}
+		Edge0 -= Setup->Edges[0].StepX;
+		Edge1 -= Setup->Edges[1].StepX;
+		Edge2 -= Setup->Edges[2].StepX;
+	}
+	*RunX1 = x;
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Functions
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -89,6 +301,96 @@ void Draw_Textured_Triangle(
 	upng_t* texture
 );
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Small-primitive culling: classify a projected triangle by the pixel centers it could cover
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Uses the same snapped vertices, bounding box and fill rule as Setup_Triangle, but stops before any of the
+// floating point attributes: a culled triangle is exactly one the edge function rasterizer wouldn't draw
+// any pixel of. Triangles outside the screen or too big are left as regular, Setup_Triangle rejects them
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Classify_Triangle_Size(vec4_t VertexA, vec4_t VertexB, vec4_t VertexC);
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Compute the edge functions and the 1/W, U/W and V/W plane equations of a triangle
+// Returns false if the triangle has no area, falls completely outside the screen or is bigger than RASTER_MAX_EXTENT
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Setup_Triangle(
+	triangle_setup_t* Setup,
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	tex2_t AUV, tex2_t BUV, tex2_t CUV
+);
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scalar pixel loops of the edge function rasterizer, one per kind of block
+// Full blocks are known to be inside the triangle, so they don't test the edge functions
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Fill_Solid_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Solid_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Textured_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Textured_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Depth_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Depth_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Visibility_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Visibility_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Textured_Equal_Block_Partial(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Textured_Equal_Block_Full(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Setup a filled or textured triangle without drawing it yet (the texture info is stored in the setup)
+// Return false if there's nothing to draw, like Setup_Triangle
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Setup_Filled_Triangle(
+	triangle_setup_t* Setup,
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	color_t Color
+);
+
+bool Setup_Textured_Triangle(
+	triangle_setup_t* Setup,
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	tex2_t AUV, tex2_t BUV, tex2_t CUV,
+	upng_t* Texture
+);
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Rasterize only the pixels of an already setup triangle that fall inside the rectangle (X0,Y0)-(X1,Y1)
+// Different rectangles never touch the same pixels, so they can be rasterized at the same time by different threads
+// Returns how many pixels were shaded, for the frame statistics. The pixels go to the buffers of Target, which have
+// to cover the whole rectangle (Get_Screen_Target, or the buffers of a tile)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Rasterize_Triangle_Rect(const triangle_setup_t* Setup, const render_target_t* Target, int Pass, int X0, int Y0, int X1, int Y1);
+
+// Rasterize the whole bounding box of an already setup triangle (color pass) and count its shaded pixels
+void Draw_Triangle_Setup(const triangle_setup_t* Setup);
+
+///////////////////////////////////////////////////////////////////////////////
+// Draw a filled triangle with incrementally stepped edge functions
+///////////////////////////////////////////////////////////////////////////////
+
+void Draw_Filled_Triangle_Edge_Function(
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	color_t Color
+);
+
+///////////////////////////////////////////////////////////////////////////////
+// Draw a textured triangle with incrementally stepped edge functions
+///////////////////////////////////////////////////////////////////////////////
+
+void Draw_Textured_Triangle_Edge_Function(
+	vec4_t VertexA, vec4_t VertexB, vec4_t VertexC,
+	tex2_t AUV, tex2_t BUV, tex2_t CUV,
+	upng_t* Texture
+);
+
+// Twice the signed area of a projected triangle, in pixels: positive for the faces that look at the camera
+// (the screen Y axis grows downwards, which flips the winding the face normal is computed with)
+float Get_Triangle_Screen_Area(vec4_t VertexA, vec4_t VertexB, vec4_t VertexC);
+
 vec3_t Get_Triangle_Normal(vec4_t* TriangleVertices);
 
 #endif
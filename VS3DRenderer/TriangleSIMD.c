@@ -0,0 +1,631 @@
+#include "TriangleSIMD.h"
+
+#if defined(RASTER_SIMD_AVX2) || defined(RASTER_SIMD_SSE2)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Thin wrappers over the SSE2/AVX2 intrinsics, so the pixel loops below are written only once for both widths
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(RASTER_SIMD_AVX2)
+
+#include <immintrin.h>
+
+typedef __m256 simd_float_t; // 8 floats
+typedef __m256i simd_int_t; // 8 32bit integers
+
+#define SIMD_SET1(Value)             _mm256_set1_ps(Value)
+#define SIMD_LANE_OFFSETS()          _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7)
+#define SIMD_LOAD(Pointer)           _mm256_loadu_ps(Pointer)
+#define SIMD_STORE(Pointer, Value)   _mm256_storeu_ps(Pointer, Value)
+#define SIMD_LOAD_INT(Pointer)       _mm256_loadu_si256((const __m256i*)(Pointer))
+#define SIMD_STORE_INT(Pointer, Value) _mm256_storeu_si256((__m256i*)(Pointer), Value)
+#define SIMD_ADD(A, B)               _mm256_add_ps(A, B)
+#define SIMD_SUB(A, B)               _mm256_sub_ps(A, B)
+#define SIMD_MUL(A, B)               _mm256_mul_ps(A, B)
+#define SIMD_DIV(A, B)               _mm256_div_ps(A, B)
+#define SIMD_RCP(Value)              _mm256_rcp_ps(Value)
+#define SIMD_AND(A, B)               _mm256_and_ps(A, B)
+#define SIMD_MIN(A, B)               _mm256_min_ps(A, B)
+#define SIMD_MAX(A, B)               _mm256_max_ps(A, B)
+#define SIMD_CMPGE(A, B)             _mm256_cmp_ps(A, B, _CMP_GE_OQ)
+#define SIMD_CMPLT(A, B)             _mm256_cmp_ps(A, B, _CMP_LT_OQ)
+#define SIMD_CMPEQ(A, B)             _mm256_cmp_ps(A, B, _CMP_EQ_OQ)
+#define SIMD_BLEND(Old, New, Mask)   _mm256_blendv_ps(Old, New, Mask)
+#define SIMD_MOVEMASK(Mask)          _mm256_movemask_ps(Mask)
+#define SIMD_TRUNCATE(Value)         _mm256_cvttps_epi32(Value)
+#define SIMD_TO_FLOAT(Value)         _mm256_cvtepi32_ps(Value)
+#define SIMD_AS_INT(Value)           _mm256_castps_si256(Value)
+#define SIMD_INT_SET1(Value)         _mm256_set1_epi32(Value)
+#define SIMD_INT_AND(A, B)           _mm256_and_si256(A, B)
+#define SIMD_INT_XOR(A, B)           _mm256_xor_si256(A, B)
+#define SIMD_INT_SUB(A, B)           _mm256_sub_epi32(A, B)
+#define SIMD_INT_SHIFT_SIGN(Value)   _mm256_srai_epi32(Value, 31)
+#define SIMD_INT_BLEND(Old, New, Mask) _mm256_blendv_epi8(Old, New, Mask)
+#define SIMD_INT_ADD(A, B)           _mm256_add_epi32(A, B)
+#define SIMD_INT_OR(A, B)            _mm256_or_si256(A, B)
+#define SIMD_INT_CMPGT(A, B)         _mm256_cmpgt_epi32(A, B)
+#define SIMD_INT_CMPEQ(A, B)         _mm256_cmpeq_epi32(A, B)
+#define SIMD_AS_FLOAT(Value)         _mm256_castsi256_ps(Value)
+// Base + (lane * Step) in each lane
+#define SIMD_INT_RAMP(Base, Step)    _mm256_add_epi32(_mm256_set1_epi32(Base), _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(Step)))
+
+// Fetch the texels of the lanes in Mask with a hardware gather, keeping the old colors in the other lanes
+SDL_FORCE_INLINE simd_int_t Simd_Gather_Texels(const color_t* TextureBuffer, simd_int_t Index, simd_int_t Mask, simd_int_t OldColor)
+{
+	return _mm256_mask_i32gather_epi32(OldColor, (const int*)TextureBuffer, Index, Mask, 4);
+}
+
+// 16bit depths, widened to one per 32bit lane
+#define SIMD_LOAD_DEPTH16(Pointer)   _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(Pointer)))
+
+SDL_FORCE_INLINE void Simd_Store_Depth16(uint16_t* Pointer, simd_int_t Value)
+{
+	// The pack works inside each 128bit half, so the 2 groups of 4 depths are moved together before storing them
+	simd_int_t Packed = _mm256_packus_epi32(Value, Value);
+	_mm_storeu_si128((__m128i*)Pointer, _mm256_castsi256_si128(_mm256_permute4x64_epi64(Packed, 0x08)));
+}
+
+#else
+
+#include <emmintrin.h>
+
+typedef __m128 simd_float_t; // 4 floats
+typedef __m128i simd_int_t; // 4 32bit integers
+
+#define SIMD_SET1(Value)             _mm_set1_ps(Value)
+#define SIMD_LANE_OFFSETS()          _mm_setr_ps(0, 1, 2, 3)
+#define SIMD_LOAD(Pointer)           _mm_loadu_ps(Pointer)
+#define SIMD_STORE(Pointer, Value)   _mm_storeu_ps(Pointer, Value)
+#define SIMD_LOAD_INT(Pointer)       _mm_loadu_si128((const __m128i*)(Pointer))
+#define SIMD_STORE_INT(Pointer, Value) _mm_storeu_si128((__m128i*)(Pointer), Value)
+#define SIMD_ADD(A, B)               _mm_add_ps(A, B)
+#define SIMD_SUB(A, B)               _mm_sub_ps(A, B)
+#define SIMD_MUL(A, B)               _mm_mul_ps(A, B)
+#define SIMD_DIV(A, B)               _mm_div_ps(A, B)
+#define SIMD_RCP(Value)              _mm_rcp_ps(Value)
+#define SIMD_AND(A, B)               _mm_and_ps(A, B)
+#define SIMD_MIN(A, B)               _mm_min_ps(A, B)
+#define SIMD_MAX(A, B)               _mm_max_ps(A, B)
+#define SIMD_CMPGE(A, B)             _mm_cmpge_ps(A, B)
+#define SIMD_CMPLT(A, B)             _mm_cmplt_ps(A, B)
+#define SIMD_CMPEQ(A, B)             _mm_cmpeq_ps(A, B)
+// SSE2 doesn't have blend instructions: (New & Mask) | (Old & ~Mask)
+#define SIMD_BLEND(Old, New, Mask)   _mm_or_ps(_mm_and_ps(Mask, New), _mm_andnot_ps(Mask, Old))
+#define SIMD_MOVEMASK(Mask)          _mm_movemask_ps(Mask)
+#define SIMD_TRUNCATE(Value)         _mm_cvttps_epi32(Value)
+#define SIMD_TO_FLOAT(Value)         _mm_cvtepi32_ps(Value)
+#define SIMD_AS_INT(Value)           _mm_castps_si128(Value)
+#define SIMD_INT_SET1(Value)         _mm_set1_epi32(Value)
+#define SIMD_INT_AND(A, B)           _mm_and_si128(A, B)
+#define SIMD_INT_XOR(A, B)           _mm_xor_si128(A, B)
+#define SIMD_INT_SUB(A, B)           _mm_sub_epi32(A, B)
+#define SIMD_INT_SHIFT_SIGN(Value)   _mm_srai_epi32(Value, 31)
+#define SIMD_INT_BLEND(Old, New, Mask) _mm_or_si128(_mm_and_si128(Mask, New), _mm_andnot_si128(Mask, Old))
+#define SIMD_INT_ADD(A, B)           _mm_add_epi32(A, B)
+#define SIMD_INT_OR(A, B)            _mm_or_si128(A, B)
+#define SIMD_INT_CMPGT(A, B)         _mm_cmpgt_epi32(A, B)
+#define SIMD_INT_CMPEQ(A, B)         _mm_cmpeq_epi32(A, B)
+#define SIMD_AS_FLOAT(Value)         _mm_castsi128_ps(Value)
+// Base + (lane * Step) in each lane (SSE2 can't multiply 32 bit integers, but these are only computed once per row)
+#define SIMD_INT_RAMP(Base, Step)    _mm_setr_epi32(Base, (Base) + (Step), (Base) + 2 * (Step), (Base) + 3 * (Step))
+
+// SSE2 has no gather instruction, so load the texels one by one. The lanes outside Mask have index 0 (always a valid
+// texel), so the 4 loads don't need branches and the mask just keeps the old colors in those lanes
+SDL_FORCE_INLINE simd_int_t Simd_Gather_Texels(const color_t* TextureBuffer, simd_int_t Index, simd_int_t Mask, simd_int_t OldColor)
+{
+	int Indices[4];
+	_mm_storeu_si128((__m128i*)Indices, Index);
+
+	simd_int_t Texels = _mm_setr_epi32((int)TextureBuffer[Indices[0]], (int)TextureBuffer[Indices[1]],
+		(int)TextureBuffer[Indices[2]], (int)TextureBuffer[Indices[3]]);
+	return SIMD_INT_BLEND(OldColor, Texels, Mask);
+}
+
+// 16bit depths, widened to one per 32bit lane
+#define SIMD_LOAD_DEPTH16(Pointer)   _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(Pointer)), _mm_setzero_si128())
+
+SDL_FORCE_INLINE void Simd_Store_Depth16(uint16_t* Pointer, simd_int_t Value)
+{
+	// SSE2 can only pack with signed saturation, so the depths are moved to the signed range and back (flipping the top bit)
+	simd_int_t Packed = _mm_packs_epi32(_mm_sub_epi32(Value, _mm_set1_epi32(0x8000)), _mm_setzero_si128());
+	_mm_storel_epi64((__m128i*)Pointer, _mm_xor_si128(Packed, _mm_set1_epi16((short)0x8000)));
+}
+
+#endif
+
+// 1/X of the perspective interpolation, approximated the same way as Interpolation_Divide when compiling with FAST_RECIPROCAL
+SDL_FORCE_INLINE simd_float_t Simd_Reciprocal(simd_float_t X)
+{
+#if defined(INTERPOLATION_FAST_RECIPROCAL)
+	simd_float_t Estimate = SIMD_RCP(X);
+	return SIMD_MUL(Estimate, SIMD_SUB(SIMD_SET1(2.0f), SIMD_MUL(X, Estimate)));
+#else
+	return SIMD_DIV(SIMD_SET1(1.0f), X);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Map a texture coordinate to a texel column/row, the same way the scalar loop does: abs((int)(Coord)) % Size
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// There's no integer division in SIMD, so the modulus is computed with floats: Coord - (int)(Coord / Size) * Size
+// That's exact as long as the values fit in the 24 bits of the float mantissa (textures up to 16 million texels)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SDL_FORCE_INLINE simd_float_t Simd_Wrap_Texel(simd_float_t Coord, simd_float_t Size, simd_float_t ReciprocalSize)
+{
+	simd_int_t Truncated = SIMD_TRUNCATE(Coord);
+
+	// Absolute value without branches: (Value ^ Sign) - Sign, with Sign being all ones for negative values
+	simd_int_t Sign = SIMD_INT_SHIFT_SIGN(Truncated);
+	simd_float_t Absolute = SIMD_TO_FLOAT(SIMD_INT_SUB(SIMD_INT_XOR(Truncated, Sign), Sign));
+
+	simd_float_t Quotient = SIMD_TO_FLOAT(SIMD_TRUNCATE(SIMD_MUL(Absolute, ReciprocalSize)));
+	simd_float_t Remainder = SIMD_SUB(Absolute, SIMD_MUL(Quotient, Size));
+
+	// Multiplying by the reciprocal can round the quotient one unit off, so bring the remainder back into [0, Size)
+	Remainder = SIMD_SUB(Remainder, SIMD_AND(SIMD_CMPGE(Remainder, Size), Size));
+	Remainder = SIMD_ADD(Remainder, SIMD_AND(SIMD_CMPLT(Remainder, SIMD_SET1(0)), Size));
+	return Remainder;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Depths of a group of pixels, the same values as Make_Depth/Test_Depth/Store_Depth for each format
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The integer depths are carried in the bits of a simd_float_t too, so the pixel loops blend every format the same way
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SDL_FORCE_INLINE simd_float_t Simd_Make_Depth(simd_float_t ReciprocalW, simd_float_t DepthBias, simd_float_t DepthScale, int DepthFormat)
+{
+	if (DepthFormat == DEPTH_FORMAT_FLOAT32)
+	{
+		// Adjust the reciprocal W so the pixels that are closer to the camera have smaller values
+		return SIMD_SUB(DepthBias, ReciprocalW);
+	}
+
+	uint32_t MaxValue = (DepthFormat == DEPTH_FORMAT_UNORM16) ? DEPTH_UNORM16_MAX : DEPTH_UNORM24_MAX;
+	simd_float_t Scaled = SIMD_ADD(SIMD_MUL(ReciprocalW, DepthScale), SIMD_SET1(0.5f));
+	Scaled = SIMD_MIN(SIMD_MAX(Scaled, SIMD_SET1(0.0f)), SIMD_SET1((float)MaxValue));
+	return SIMD_AS_FLOAT(SIMD_INT_SUB(SIMD_INT_SET1((int)MaxValue), SIMD_TRUNCATE(Scaled)));
+}
+
+SDL_FORCE_INLINE simd_float_t Simd_Load_Depth(const void* ZBuffer, int Index, int DepthFormat)
+{
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_UNORM16:
+		return SIMD_AS_FLOAT(SIMD_LOAD_DEPTH16(&((const uint16_t*)ZBuffer)[Index]));
+	case DEPTH_FORMAT_UNORM24:
+		return SIMD_AS_FLOAT(SIMD_LOAD_INT(&((const uint32_t*)ZBuffer)[Index]));
+	default:
+		return SIMD_LOAD(&((const float*)ZBuffer)[Index]);
+	}
+}
+
+// Mask of the lanes closer than the old depth, or with exactly the same depth when bEqualDepth
+SDL_FORCE_INLINE simd_float_t Simd_Test_Depth(simd_float_t Depth, simd_float_t OldDepth, int DepthFormat, bool bEqualDepth)
+{
+	if (DepthFormat == DEPTH_FORMAT_FLOAT32)
+	{
+		return bEqualDepth ? SIMD_CMPEQ(Depth, OldDepth) : SIMD_CMPLT(Depth, OldDepth);
+	}
+
+	// The integer depths are at most 24 bits, so the signed comparison is fine for them
+	simd_int_t IntDepth = SIMD_AS_INT(Depth);
+	simd_int_t IntOldDepth = SIMD_AS_INT(OldDepth);
+	return SIMD_AS_FLOAT(bEqualDepth ? SIMD_INT_CMPEQ(IntDepth, IntOldDepth) : SIMD_INT_CMPGT(IntOldDepth, IntDepth));
+}
+
+SDL_FORCE_INLINE void Simd_Store_Depth(void* ZBuffer, int Index, simd_float_t Depth, int DepthFormat)
+{
+	switch (DepthFormat)
+	{
+	case DEPTH_FORMAT_UNORM16:
+		Simd_Store_Depth16(&((uint16_t*)ZBuffer)[Index], SIMD_AS_INT(Depth));
+		break;
+	case DEPTH_FORMAT_UNORM24:
+		SIMD_STORE_INT(&((uint32_t*)ZBuffer)[Index], SIMD_AS_INT(Depth));
+		break;
+	default:
+		SIMD_STORE(&((float*)ZBuffer)[Index], Depth);
+		break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Number of lanes that are on in a SIMD_MOVEMASK result (at most 8 bits), without needing the POPCNT instruction
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SDL_FORCE_INLINE int Count_Lanes(int LaneMask)
+{
+	LaneMask = LaneMask - ((LaneMask >> 1) & 0x55);
+	LaneMask = (LaneMask & 0x33) + ((LaneMask >> 2) & 0x33);
+	return (LaneMask + (LaneMask >> 4)) & 0x0F;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pixels of a row that aren't part of a whole group go through the scalar loop with the same flags
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SDL_FORCE_INLINE int Fill_Solid_Row_Scalar(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int X1, int y, bool bTestEdges, bool bWriteColor, bool bWriteId)
+{
+	if (bWriteId)
+	{
+		return bTestEdges ? Fill_Visibility_Block_Partial(Setup, Target, X0, y, X1, y) : Fill_Visibility_Block_Full(Setup, Target, X0, y, X1, y);
+	}
+	if (bWriteColor)
+	{
+		return bTestEdges ? Fill_Solid_Block_Partial(Setup, Target, X0, y, X1, y) : Fill_Solid_Block_Full(Setup, Target, X0, y, X1, y);
+	}
+	return bTestEdges ? Fill_Depth_Block_Partial(Setup, Target, X0, y, X1, y) : Fill_Depth_Block_Full(Setup, Target, X0, y, X1, y);
+}
+
+SDL_FORCE_INLINE int Fill_Textured_Row_Scalar(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int X1, int y, bool bTestEdges, bool bEqualDepth)
+{
+	if (bEqualDepth)
+	{
+		return bTestEdges ? Fill_Textured_Equal_Block_Partial(Setup, Target, X0, y, X1, y) : Fill_Textured_Equal_Block_Full(Setup, Target, X0, y, X1, y);
+	}
+	return bTestEdges ? Fill_Textured_Block_Partial(Setup, Target, X0, y, X1, y) : Fill_Textured_Block_Full(Setup, Target, X0, y, X1, y);
+}
+
+// First pixel of the groups of a row that starts at X0. With TILED_FRAMEBUFFER the groups start at multiples of
+// RASTER_SIMD_WIDTH, so the pixels of each group are contiguous (inside one row of a tile), and the ones before go scalar
+SDL_FORCE_INLINE int First_Group_X(int X0)
+{
+#if defined(TILED_FRAMEBUFFER)
+	return (X0 + RASTER_SIMD_WIDTH - 1) & ~(RASTER_SIMD_WIDTH - 1);
+#else
+	return X0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SIMD pixel loops
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Each iteration takes a group of RASTER_SIMD_WIDTH consecutive pixels of the row and builds a mask with one lane
+	per pixel: inside the 3 edges AND closer than the depth buffer. Then every lane is shaded at the same time,
+	and the mask decides which lanes are actually written back (the others keep their old color and depth).
+	The bounding box is already clamped to the screen, so there are no bounds checks inside the loops.
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SDL_FORCE_INLINE int Fill_Solid_Pixels_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1, bool bTestEdges, bool bWriteColor, bool bWriteId, int DepthFormat)
+{
+	int BufferWidth = Target->Width;
+	int OriginX = Target->OriginX;
+	int OriginY = Target->OriginY;
+	color_t* ColorBuffer = bWriteId ? Target->VisibilityBuffer : Target->ColorBuffer;
+	void* ZBuffer = Target->ZBuffer;
+
+	simd_float_t Zero = SIMD_SET1(0);
+	simd_float_t One = SIMD_SET1(1);
+	simd_float_t DepthBias = SIMD_SET1(Get_Depth_Bias()); // See DEPTH_GENERATIONS
+	simd_float_t DepthScale = SIMD_SET1(Get_Depth_Scale());
+	simd_float_t LaneOffsets = SIMD_LANE_OFFSETS();
+	simd_int_t MinusOne = SIMD_INT_SET1(-1);
+	simd_int_t Color = SIMD_INT_SET1((int)(bWriteId ? Target->TriangleId : Setup->Color));
+
+	// How much the values change from one pixel to the next one, and from one group of pixels to the next one
+	int32_t Edge0StepX = Setup->Edges[0].StepX, Edge0StepY = Setup->Edges[0].StepY;
+	int32_t Edge1StepX = Setup->Edges[1].StepX, Edge1StepY = Setup->Edges[1].StepY;
+	int32_t Edge2StepX = Setup->Edges[2].StepX, Edge2StepY = Setup->Edges[2].StepY;
+	float ReciprocalWStepX = Setup->ReciprocalW.StepX, ReciprocalWStepY = Setup->ReciprocalW.StepY;
+
+	simd_int_t Edge0GroupStep = SIMD_INT_SET1(Edge0StepX * RASTER_SIMD_WIDTH);
+	simd_int_t Edge1GroupStep = SIMD_INT_SET1(Edge1StepX * RASTER_SIMD_WIDTH);
+	simd_int_t Edge2GroupStep = SIMD_INT_SET1(Edge2StepX * RASTER_SIMD_WIDTH);
+	simd_float_t ReciprocalWGroupStep = SIMD_SET1(ReciprocalWStepX * RASTER_SIMD_WIDTH);
+
+	int32_t RowEdge0 = Edge_Equation_At(&Setup->Edges[0], Setup, X0, Y0);
+	int32_t RowEdge1 = Edge_Equation_At(&Setup->Edges[1], Setup, X0, Y0);
+	int32_t RowEdge2 = Edge_Equation_At(&Setup->Edges[2], Setup, X0, Y0);
+	float RowReciprocalW = Plane_Equation_At(&Setup->ReciprocalW, Setup, X0, Y0);
+	int ShadedPixels = 0;
+
+	for (int y = Y0; y <= Y1; y++)
+	{
+		int x = First_Group_X(X0);
+		int SkippedPixels = x - X0;
+		if (SkippedPixels > 0)
+		{
+			ShadedPixels += Fill_Solid_Row_Scalar(Setup, Target, X0, SDL_min(x - 1, X1), y, bTestEdges, bWriteColor, bWriteId);
+		}
+
+		// Values for each lane of the first group: row value + ((skipped pixels + lane) * step)
+		simd_int_t Edge0 = SIMD_INT_RAMP(RowEdge0 + (Edge0StepX * SkippedPixels), Edge0StepX);
+		simd_int_t Edge1 = SIMD_INT_RAMP(RowEdge1 + (Edge1StepX * SkippedPixels), Edge1StepX);
+		simd_int_t Edge2 = SIMD_INT_RAMP(RowEdge2 + (Edge2StepX * SkippedPixels), Edge2StepX);
+		simd_float_t FirstLanes = SIMD_ADD(LaneOffsets, SIMD_SET1((float)SkippedPixels));
+		simd_float_t ReciprocalW = SIMD_ADD(SIMD_SET1(RowReciprocalW), SIMD_MUL(FirstLanes, SIMD_SET1(ReciprocalWStepX)));
+
+		int RowIndex = Pixel_Row_Offset(y - OriginY, BufferWidth);
+
+		for (; x + RASTER_SIMD_WIDTH - 1 <= X1; x += RASTER_SIMD_WIDTH)
+		{
+			int PixelIndex = RowIndex + Pixel_Column_Offset(x - OriginX);
+			simd_float_t Mask = SIMD_CMPGE(One, Zero); // All lanes on
+			if (bTestEdges)
+			{
+				// Inside the 3 edges when none of them has the sign bit set
+				simd_int_t AllEdges = SIMD_INT_OR(SIMD_INT_OR(Edge0, Edge1), Edge2);
+				Mask = SIMD_AS_FLOAT(SIMD_INT_CMPGT(AllEdges, MinusOne));
+			}
+
+			if (!bTestEdges || SIMD_MOVEMASK(Mask) != 0)
+			{
+				simd_float_t Depth = Simd_Make_Depth(ReciprocalW, DepthBias, DepthScale, DepthFormat);
+				simd_float_t OldDepth = Simd_Load_Depth(ZBuffer, PixelIndex, DepthFormat);
+				Mask = SIMD_AND(Mask, Simd_Test_Depth(Depth, OldDepth, DepthFormat, false));
+
+				int LaneMask = SIMD_MOVEMASK(Mask);
+				if (LaneMask != 0)
+				{
+					if (bWriteColor)
+					{
+						simd_int_t OldColor = SIMD_LOAD_INT(&ColorBuffer[PixelIndex]);
+						SIMD_STORE_INT(&ColorBuffer[PixelIndex], SIMD_INT_BLEND(OldColor, Color, SIMD_AS_INT(Mask)));
+						ShadedPixels += bWriteId ? 0 : Count_Lanes(LaneMask);
+					}
+					Simd_Store_Depth(ZBuffer, PixelIndex, SIMD_BLEND(OldDepth, Depth, Mask), DepthFormat);
+				}
+			}
+
+			Edge0 = SIMD_INT_ADD(Edge0, Edge0GroupStep);
+			Edge1 = SIMD_INT_ADD(Edge1, Edge1GroupStep);
+			Edge2 = SIMD_INT_ADD(Edge2, Edge2GroupStep);
+			ReciprocalW = SIMD_ADD(ReciprocalW, ReciprocalWGroupStep);
+		}
+
+		// The remaining pixels of the row are less than a full group
+		if (x <= X1)
+		{
+			ShadedPixels += Fill_Solid_Row_Scalar(Setup, Target, x, X1, y, bTestEdges, bWriteColor, bWriteId);
+		}
+
+		RowEdge0 += Edge0StepY;
+		RowEdge1 += Edge1StepY;
+		RowEdge2 += Edge2StepY;
+		RowReciprocalW += ReciprocalWStepY;
+	}
+
+	return ShadedPixels;
+}
+
+SDL_FORCE_INLINE int Fill_Textured_Pixels_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1, bool bTestEdges, bool bEqualDepth, int DepthFormat)
+{
+	int BufferWidth = Target->Width;
+	int OriginX = Target->OriginX;
+	int OriginY = Target->OriginY;
+	color_t* ColorBuffer = Target->ColorBuffer;
+	void* ZBuffer = Target->ZBuffer;
+	color_t* TextureBuffer = Setup->TextureBuffer;
+
+	simd_float_t Zero = SIMD_SET1(0);
+	simd_float_t One = SIMD_SET1(1);
+	simd_float_t DepthBias = SIMD_SET1(Get_Depth_Bias()); // See DEPTH_GENERATIONS
+	simd_float_t DepthScale = SIMD_SET1(Get_Depth_Scale());
+	simd_float_t LaneOffsets = SIMD_LANE_OFFSETS();
+	simd_int_t MinusOne = SIMD_INT_SET1(-1);
+	simd_float_t TextureWidth = SIMD_SET1((float)Setup->TextureWidth);
+	simd_float_t TextureHeight = SIMD_SET1((float)Setup->TextureHeight);
+	simd_float_t ReciprocalTextureWidth = SIMD_SET1(1.0f / Setup->TextureWidth);
+	simd_float_t ReciprocalTextureHeight = SIMD_SET1(1.0f / Setup->TextureHeight);
+
+	// How much the values change from one pixel to the next one, and from one group of pixels to the next one
+	int32_t Edge0StepX = Setup->Edges[0].StepX, Edge0StepY = Setup->Edges[0].StepY;
+	int32_t Edge1StepX = Setup->Edges[1].StepX, Edge1StepY = Setup->Edges[1].StepY;
+	int32_t Edge2StepX = Setup->Edges[2].StepX, Edge2StepY = Setup->Edges[2].StepY;
+	float ReciprocalWStepX = Setup->ReciprocalW.StepX, ReciprocalWStepY = Setup->ReciprocalW.StepY;
+	float UOverWStepX = Setup->UOverW.StepX, UOverWStepY = Setup->UOverW.StepY;
+	float VOverWStepX = Setup->VOverW.StepX, VOverWStepY = Setup->VOverW.StepY;
+
+	simd_int_t Edge0GroupStep = SIMD_INT_SET1(Edge0StepX * RASTER_SIMD_WIDTH);
+	simd_int_t Edge1GroupStep = SIMD_INT_SET1(Edge1StepX * RASTER_SIMD_WIDTH);
+	simd_int_t Edge2GroupStep = SIMD_INT_SET1(Edge2StepX * RASTER_SIMD_WIDTH);
+	simd_float_t ReciprocalWGroupStep = SIMD_SET1(ReciprocalWStepX * RASTER_SIMD_WIDTH);
+	simd_float_t UOverWGroupStep = SIMD_SET1(UOverWStepX * RASTER_SIMD_WIDTH);
+	simd_float_t VOverWGroupStep = SIMD_SET1(VOverWStepX * RASTER_SIMD_WIDTH);
+
+	int32_t RowEdge0 = Edge_Equation_At(&Setup->Edges[0], Setup, X0, Y0);
+	int32_t RowEdge1 = Edge_Equation_At(&Setup->Edges[1], Setup, X0, Y0);
+	int32_t RowEdge2 = Edge_Equation_At(&Setup->Edges[2], Setup, X0, Y0);
+	float RowReciprocalW = Plane_Equation_At(&Setup->ReciprocalW, Setup, X0, Y0);
+	float RowUOverW = Plane_Equation_At(&Setup->UOverW, Setup, X0, Y0);
+	float RowVOverW = Plane_Equation_At(&Setup->VOverW, Setup, X0, Y0);
+	int ShadedPixels = 0;
+
+	for (int y = Y0; y <= Y1; y++)
+	{
+		int x = First_Group_X(X0);
+		int SkippedPixels = x - X0;
+		if (SkippedPixels > 0)
+		{
+			ShadedPixels += Fill_Textured_Row_Scalar(Setup, Target, X0, SDL_min(x - 1, X1), y, bTestEdges, bEqualDepth);
+		}
+
+		// Values for each lane of the first group: row value + ((skipped pixels + lane) * step)
+		simd_int_t Edge0 = SIMD_INT_RAMP(RowEdge0 + (Edge0StepX * SkippedPixels), Edge0StepX);
+		simd_int_t Edge1 = SIMD_INT_RAMP(RowEdge1 + (Edge1StepX * SkippedPixels), Edge1StepX);
+		simd_int_t Edge2 = SIMD_INT_RAMP(RowEdge2 + (Edge2StepX * SkippedPixels), Edge2StepX);
+		simd_float_t FirstLanes = SIMD_ADD(LaneOffsets, SIMD_SET1((float)SkippedPixels));
+		simd_float_t ReciprocalW = SIMD_ADD(SIMD_SET1(RowReciprocalW), SIMD_MUL(FirstLanes, SIMD_SET1(ReciprocalWStepX)));
+		simd_float_t UOverW = SIMD_ADD(SIMD_SET1(RowUOverW), SIMD_MUL(FirstLanes, SIMD_SET1(UOverWStepX)));
+		simd_float_t VOverW = SIMD_ADD(SIMD_SET1(RowVOverW), SIMD_MUL(FirstLanes, SIMD_SET1(VOverWStepX)));
+
+		int RowIndex = Pixel_Row_Offset(y - OriginY, BufferWidth);
+
+		for (; x + RASTER_SIMD_WIDTH - 1 <= X1; x += RASTER_SIMD_WIDTH)
+		{
+			int PixelIndex = RowIndex + Pixel_Column_Offset(x - OriginX);
+			simd_float_t Mask = SIMD_CMPGE(One, Zero); // All lanes on
+			if (bTestEdges)
+			{
+				// Inside the 3 edges when none of them has the sign bit set
+				simd_int_t AllEdges = SIMD_INT_OR(SIMD_INT_OR(Edge0, Edge1), Edge2);
+				Mask = SIMD_AS_FLOAT(SIMD_INT_CMPGT(AllEdges, MinusOne));
+			}
+
+			if (!bTestEdges || SIMD_MOVEMASK(Mask) != 0)
+			{
+				simd_float_t Depth = Simd_Make_Depth(ReciprocalW, DepthBias, DepthScale, DepthFormat);
+				simd_float_t OldDepth = Simd_Load_Depth(ZBuffer, PixelIndex, DepthFormat);
+				Mask = SIMD_AND(Mask, Simd_Test_Depth(Depth, OldDepth, DepthFormat, bEqualDepth));
+
+				// Only shade the group if at least one of its pixels is visible
+				int LaneMask = SIMD_MOVEMASK(Mask);
+				if (LaneMask != 0)
+				{
+					// Divide the interpolated U/W and V/W by the interpolated 1/W (undo the perspective transform)
+					simd_float_t W = Simd_Reciprocal(ReciprocalW);
+					simd_float_t TextureX = Simd_Wrap_Texel(SIMD_MUL(SIMD_MUL(UOverW, W), TextureWidth), TextureWidth, ReciprocalTextureWidth);
+					simd_float_t TextureY = Simd_Wrap_Texel(SIMD_MUL(SIMD_MUL(VOverW, W), TextureHeight), TextureHeight, ReciprocalTextureHeight);
+
+					// The lanes outside the mask could have any garbage index, so they're forced to 0
+					simd_int_t IntMask = SIMD_AS_INT(Mask);
+					simd_int_t TextureIndex = SIMD_TRUNCATE(SIMD_ADD(SIMD_MUL(TextureY, TextureWidth), TextureX));
+					TextureIndex = SIMD_INT_AND(TextureIndex, IntMask);
+
+					simd_int_t OldColor = SIMD_LOAD_INT(&ColorBuffer[PixelIndex]);
+					simd_int_t NewColor = Simd_Gather_Texels(TextureBuffer, TextureIndex, IntMask, OldColor);
+					SIMD_STORE_INT(&ColorBuffer[PixelIndex], NewColor);
+					ShadedPixels += Count_Lanes(LaneMask);
+					if (!bEqualDepth)
+					{
+						Simd_Store_Depth(ZBuffer, PixelIndex, SIMD_BLEND(OldDepth, Depth, Mask), DepthFormat);
+					}
+				}
+			}
+
+			Edge0 = SIMD_INT_ADD(Edge0, Edge0GroupStep);
+			Edge1 = SIMD_INT_ADD(Edge1, Edge1GroupStep);
+			Edge2 = SIMD_INT_ADD(Edge2, Edge2GroupStep);
+			ReciprocalW = SIMD_ADD(ReciprocalW, ReciprocalWGroupStep);
+			UOverW = SIMD_ADD(UOverW, UOverWGroupStep);
+			VOverW = SIMD_ADD(VOverW, VOverWGroupStep);
+		}
+
+		// The remaining pixels of the row are less than a full group
+		if (x <= X1)
+		{
+			ShadedPixels += Fill_Textured_Row_Scalar(Setup, Target, x, X1, y, bTestEdges, bEqualDepth);
+		}
+
+		RowEdge0 += Edge0StepY;
+		RowEdge1 += Edge1StepY;
+		RowEdge2 += Edge2StepY;
+		RowReciprocalW += ReciprocalWStepY;
+		RowUOverW += UOverWStepY;
+		RowVOverW += VOverWStepY;
+	}
+
+	return ShadedPixels;
+}
+
+int Fill_Solid_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, true, true, false);
+}
+
+int Fill_Solid_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, false, true, false);
+}
+
+int Fill_Textured_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Textured_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, true, false);
+}
+
+int Fill_Textured_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Textured_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, false, false);
+}
+
+int Fill_Depth_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, true, false, false);
+}
+
+int Fill_Depth_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, false, false, false);
+}
+
+int Fill_Visibility_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, true, true, true);
+}
+
+int Fill_Visibility_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Solid_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, false, true, true);
+}
+
+int Fill_Textured_Equal_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Textured_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, true, true);
+}
+
+int Fill_Textured_Equal_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	CALL_WITH_DEPTH_FORMAT(Fill_Textured_Pixels_SIMD, Setup, Target, X0, Y0, X1, Y1, false, true);
+}
+
+#else
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// No SIMD instructions available, use the scalar loops
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Fill_Solid_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Solid_Block_Partial(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Solid_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Solid_Block_Full(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Textured_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Textured_Block_Partial(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Textured_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Textured_Block_Full(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Depth_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Depth_Block_Partial(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Depth_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Depth_Block_Full(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Visibility_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Visibility_Block_Partial(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Visibility_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Visibility_Block_Full(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Textured_Equal_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Textured_Equal_Block_Partial(Setup, Target, X0, Y0, X1, Y1);
+}
+
+int Fill_Textured_Equal_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1)
+{
+	return Fill_Textured_Equal_Block_Full(Setup, Target, X0, Y0, X1, Y1);
+}
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#ifndef TRIANGLE_SIMD_H
+#define TRIANGLE_SIMD_H
+
+#include "Triangle.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SIMD pixel loops of the edge function rasterizer
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Compiling with AVX2 enabled (/arch:AVX2 in MSVC, -mavx2 in GCC/Clang) uses 8 pixels per iteration and hardware
+// texture gathers. Otherwise SSE2 (always there on x64) handles 4 pixels per iteration
+#if defined(__AVX2__)
+#define RASTER_SIMD_AVX2
+#define RASTER_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_SIMD_SSE2
+#define RASTER_SIMD_WIDTH 4
+#else
+#define RASTER_SIMD_WIDTH 1 // No SIMD support, the SIMD loops just call the scalar ones
+#endif
+
+// Same as the scalar block loops, but they shade RASTER_SIMD_WIDTH pixels of the row at the same time
+// The last pixels of each row that don't fill a whole group go through the scalar loop
+int Fill_Solid_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Solid_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Textured_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Textured_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Depth_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Depth_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Visibility_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Visibility_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Textured_Equal_Block_Partial_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+int Fill_Textured_Equal_Block_Full_SIMD(const triangle_setup_t* Setup, const render_target_t* Target, int X0, int Y0, int X1, int Y1);
+
+#endif // !TRIANGLE_SIMD_H
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "TriangleSetups.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Declare the records, kept between frames so building them doesn't allocate (they only grow)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void* RecordsMemory = NULL; // What malloc returned, a bit bigger than the records to align them
+static triangle_setup_record_t* Records = NULL; // First cache line inside RecordsMemory
+static int RecordsCapacity = 0;
+static int NumRecords = 0;
+
+// Make room for Count records, throwing away the previous ones
+static bool Reserve_Records(int Count)
+{
+	if (Count <= RecordsCapacity)
+	{
+		return true;
+	}
+
+	free(RecordsMemory);
+	RecordsMemory = malloc(((size_t)Count * sizeof(triangle_setup_record_t)) + SETUP_CACHE_LINE_SIZE - 1);
+	if (!RecordsMemory)
+	{
+		fprintf(stderr, "Error allocating the triangle setup records.\n");
+		Records = NULL;
+		RecordsCapacity = 0;
+		return false;
+	}
+
+	uintptr_t Address = ((uintptr_t)RecordsMemory + SETUP_CACHE_LINE_SIZE - 1) & ~(uintptr_t)(SETUP_CACHE_LINE_SIZE - 1);
+	Records = (triangle_setup_record_t*)Address;
+	RecordsCapacity = Count;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Setup_Triangles(const Triangle_t* Triangles, int NumTriangles, bool bIsTextured)
+{
+	NumRecords = 0;
+	if (!Reserve_Records(NumTriangles))
+	{
+		return;
+	}
+
+	for (int idx = 0; idx < NumTriangles; idx++)
+	{
+		const Triangle_t* Triangle = &Triangles[idx];
+		triangle_setup_t* Setup = &Records[idx].Setup;
+		bool bIsVisible;
+
+		if (bIsTextured)
+		{
+			bIsVisible = Setup_Textured_Triangle(Setup,
+				Triangle->vertex[0], Triangle->vertex[1], Triangle->vertex[2],
+				Triangle->uvCoordinates[0], Triangle->uvCoordinates[1], Triangle->uvCoordinates[2],
+				Triangle->texture);
+		}
+		else
+		{
+			bIsVisible = Setup_Filled_Triangle(Setup, Triangle->vertex[0], Triangle->vertex[1], Triangle->vertex[2], Triangle->color);
+		}
+
+		// The setup may have stopped halfway, so the bounding box is what marks it as empty
+		if (!bIsVisible)
+		{
+			Setup->MinX = 0;
+			Setup->MinY = 0;
+			Setup->MaxX = -1;
+			Setup->MaxY = -1;
+		}
+	}
+
+	NumRecords = NumTriangles;
+}
+
+void Clear_Triangle_Setups(void)
+{
+	NumRecords = 0;
+}
+
+int Get_Num_Triangle_Setups(void)
+{
+	return NumRecords;
+}
+
+const triangle_setup_t* Get_Triangle_Setup(int Index)
+{
+	return (Index < NumRecords) ? &Records[Index].Setup : NULL;
+}
+
+void Destroy_Triangle_Setups(void)
+{
+	free(RecordsMemory);
+	RecordsMemory = NULL;
+	Records = NULL;
+	RecordsCapacity = 0;
+	NumRecords = 0;
+}
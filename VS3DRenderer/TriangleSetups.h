@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef TRIANGLE_SETUPS_H
+#define TRIANGLE_SETUPS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Triangle.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Setup records of the triangles to render, built once per frame at the end of the geometry stage
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Every edge function rasterizer needs the same triangle_setup_t of each triangle (edge equations, bounding box,
+	1/W, U/W and V/W planes). Instead of each one setting the triangles up while drawing them (the interleaved bands
+	even did it once per thread), the main thread builds one record per triangle after the sort, and the raster
+	paths only read them.
+
+	There's one record per triangle to render, in the same order, so record N always belongs to triangle N. The ones
+	that can't draw anything are left empty. Records are padded to whole cache lines and the first one starts on a
+	cache line, so reading a record never touches the lines of its neighbours.
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define SETUP_CACHE_LINE_SIZE 64
+
+typedef union
+{
+	triangle_setup_t Setup;
+	uint8_t Padding[((sizeof(triangle_setup_t) + SETUP_CACHE_LINE_SIZE - 1) / SETUP_CACHE_LINE_SIZE) * SETUP_CACHE_LINE_SIZE];
+} triangle_setup_record_t;
+
+// Empty setups have nothing to draw (their bounding box is empty, so Rasterize_Triangle_Rect wouldn't draw them either)
+SDL_FORCE_INLINE bool Is_Triangle_Setup_Empty(const triangle_setup_t* Setup)
+{
+	return (Setup->MinX > Setup->MaxX);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Build the records of the filled or textured triangles, replacing the ones of the previous frame
+void Setup_Triangles(const Triangle_t* Triangles, int NumTriangles, bool bIsTextured);
+
+// Forget the records, for the frames whose raster path doesn't use them
+void Clear_Triangle_Setups(void);
+
+// Number of records built this frame (0 if they weren't built)
+int Get_Num_Triangle_Setups(void);
+
+// Record of the triangle with that index, NULL if the records weren't built this frame
+const triangle_setup_t* Get_Triangle_Setup(int Index);
+
+// Free the records
+void Destroy_Triangle_Setups(void);
+
+#endif // !TRIANGLE_SETUPS_H
@@ -0,0 +1,86 @@
+#include <stdlib.h>
+#include "Display.h"
+#include "RasterThreads.h"
+#include "Stats.h"
+#include "TriangleSetups.h"
+#include "Visibility.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Shade the visible pixels of the rows of one thread (thread K takes the rows K, K + N, K + 2N...)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void Shade_Visible_Rows(int ThreadIndex, int NumThreads)
+{
+	int WindowWidth = Get_Window_Width();
+	int WindowHeight = Get_Window_Height();
+	int BufferWidth = Get_Buffer_Width();
+	color_t* ColorBuffer = Get_ColorBuffer();
+	uint32_t* VisibilityBuffer = Get_Visibility_Buffer();
+	int ShadedPixels = 0;
+
+	for (int y = ThreadIndex; y < WindowHeight; y += NumThreads)
+	{
+		int RowIndex = Pixel_Row_Offset(y, BufferWidth);
+
+		for (int x = 0; x < WindowWidth; x++)
+		{
+			int PixelIndex = RowIndex + Pixel_Column_Offset(x);
+			uint32_t Id = VisibilityBuffer[PixelIndex];
+			if (Id == 0)
+			{
+				continue;
+			}
+
+			// The same record the ID pass rasterized, so the planes give the same values it had at this pixel
+			const triangle_setup_t* Setup = Get_Triangle_Setup(Id - 1);
+			ShadedPixels++;
+
+			// Filled triangles don't have a texture
+			if (Setup->TextureBuffer == NULL)
+			{
+				ColorBuffer[PixelIndex] = Setup->Color;
+				continue;
+			}
+
+			// Same texture lookup as the textured pixel loop: undo the perspective with the interpolated 1/W
+			float W = Interpolation_Divide(1.0f, Plane_Equation_At(&Setup->ReciprocalW, Setup, x, y));
+			float U = Plane_Equation_At(&Setup->UOverW, Setup, x, y) * W;
+			float V = Plane_Equation_At(&Setup->VOverW, Setup, x, y) * W;
+			int TextureX = abs((int)(U * Setup->TextureWidth)) % Setup->TextureWidth;
+			int TextureY = abs((int)(V * Setup->TextureHeight)) % Setup->TextureHeight;
+
+			ColorBuffer[PixelIndex] = Setup->TextureBuffer[(Setup->TextureWidth * TextureY) + TextureX];
+		}
+	}
+
+	Add_Shaded_Pixels(ShadedPixels);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Render_Visibility_Buffer(void)
+{
+	int NumSetups = Get_Num_Triangle_Setups();
+	if (NumSetups == 0)
+	{
+		return;
+	}
+
+	Clear_Visibility_Buffer();
+
+	// Only the positions matter here, each triangle writes the index of its record + 1 as its ID
+	render_target_t IdTarget = *Get_Screen_Target();
+	for (int idx = 0; idx < NumSetups; idx++)
+	{
+		const triangle_setup_t* Setup = Get_Triangle_Setup(idx);
+		if (!Is_Triangle_Setup_Empty(Setup))
+		{
+			IdTarget.TriangleId = (uint32_t)idx + 1;
+			Rasterize_Triangle_Rect(Setup, &IdTarget, RASTER_PASS_VISIBILITY, Setup->MinX, Setup->MinY, Setup->MaxX, Setup->MaxY);
+		}
+	}
+
+	Run_Raster_Job(Shade_Visible_Rows);
+}
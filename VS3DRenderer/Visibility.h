@@ -0,0 +1,33 @@
+#pragma once
+
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+
+#include <stdbool.h>
+#include "Triangle.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Visibility buffer (deferred texturing)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/*
+	Rendering is split in 2 passes:
+	1. Rasterize every triangle writing only its depth and its ID (the index of its setup record + 1, so 0 means
+	   no triangle) into the visibility buffer. The inner loop is just a depth compare and 2 writes of 32 bits,
+	   no matter how many times the pixels get overwritten.
+	2. Walk the screen once and shade each covered pixel with the setup record of its ID (see TriangleSetups.h), so
+	   no triangle is set up again, and the texture is sampled once per visible pixel, so the shading cost doesn't
+	   depend on the overdraw at all.
+
+	The IDs are left in the visibility buffer after the frame, so they can also be used for picking or debugging.
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Rasterize the IDs of the triangles of this frame's setup records (main thread) and then shade the visible pixels
+// (all the threads)
+void Render_Visibility_Buffer(void);
+
+#endif // !VISIBILITY_H